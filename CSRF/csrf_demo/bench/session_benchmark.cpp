@@ -0,0 +1,110 @@
+// Session store throughput under the demo's request mix at 1-64 concurrent
+// clients: ShardedSessionStore against the single std::unordered_map it
+// replaced, guarded by one mutex (the old map had no lock at all, which is
+// not a baseline worth measuring).
+//
+// Each client repeatedly logs in, loads /profile eight times, changes its
+// email twice and logs out, touching only its own session as a browser
+// would.
+//
+//   cd CSRF/csrf_demo/bench && g++ -std=c++17 -O2 -I.. session_benchmark.cpp -o session_benchmark -pthread
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "session_store.h"
+
+namespace baseline {
+
+// The global map of the original demo, behind one lock
+class LockedSessionMap {
+public:
+    void put(const std::string& id, Session session) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessions_[id] = std::move(session);
+    }
+
+    bool erase(const std::string& id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return sessions_.erase(id) != 0;
+    }
+
+    // find() then operator[], as /profile did
+    template <typename Fn>
+    bool read(const std::string& id, Fn fn) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sessions_.find(id) == sessions_.end()) return false;
+        fn(sessions_[id]);
+        return true;
+    }
+
+    template <typename Fn>
+    bool update(const std::string& id, Fn fn) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sessions_.find(id) == sessions_.end()) return false;
+        fn(sessions_[id]);
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<std::string, Session> sessions_;
+};
+
+} // namespace baseline
+
+const int kRequestsPerClient = 60000;
+const int kRequestsPerVisit = 12;  // login, 8 x profile, 2 x change_email, logout
+
+// Runs `clients` threads against `store` and returns requests per second
+template <typename Store>
+double run(Store& store, int clients) {
+    std::vector<std::thread> threads;
+    std::vector<size_t> sinks(clients);
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < clients; ++c) {
+        threads.emplace_back([&store, &sinks, c] {
+            size_t sink = 0;
+            for (int visit = 0; visit < kRequestsPerClient / kRequestsPerVisit; ++visit) {
+                std::string id = "client" + std::to_string(c) + "-visit" + std::to_string(visit);
+                store.put(id, {"admin", "admin@example.com", "EBAFQsf6oYx8Et6l"});
+                for (int i = 0; i < 8; ++i) {
+                    store.read(id, [&](const Session& s) {
+                        std::string html = "<h2>Welcome, " + s.username + "</h2>" + s.email +
+                                           s.csrf_token;
+                        sink += html.size();
+                    });
+                }
+                for (int i = 0; i < 2; ++i) {
+                    store.update(id, [&](Session& s) { s.email = "user" + std::to_string(i) + "@example.com"; });
+                }
+                store.erase(id);
+            }
+            sinks[c] = sink;
+        });
+    }
+    for (auto& t : threads) t.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t total = 0;
+    for (size_t s : sinks) total += s;
+    if (total == 0) std::printf("no sessions read\n");
+    return static_cast<double>(clients) * (kRequestsPerClient / kRequestsPerVisit) * kRequestsPerVisit /
+           seconds;
+}
+
+int main() {
+    std::printf("%8s %16s %16s %9s\n", "clients", "mutex+map req/s", "sharded req/s", "speedup");
+    for (int clients = 1; clients <= 64; clients *= 2) {
+        baseline::LockedSessionMap before_store;
+        ShardedSessionStore<> after_store;
+        double before = run(before_store, clients);
+        double after = run(after_store, clients);
+        std::printf("%8d %16.0f %16.0f %8.2fx\n", clients, before, after, after / before);
+    }
+    return 0;
+}
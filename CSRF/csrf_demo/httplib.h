@@ -50,6 +50,26 @@
 #define CPPHTTPLIB_SERVER_WRITE_TIMEOUT_USECOND 0
 #endif
 
+#ifndef CPPHTTPLIB_SERVER_HEADER_TIMEOUT_SECOND
+#define CPPHTTPLIB_SERVER_HEADER_TIMEOUT_SECOND 0
+#endif
+
+#ifndef CPPHTTPLIB_SERVER_HEADER_TIMEOUT_USECOND
+#define CPPHTTPLIB_SERVER_HEADER_TIMEOUT_USECOND 0
+#endif
+
+#ifndef CPPHTTPLIB_SERVER_REQUEST_TIMEOUT_SECOND
+#define CPPHTTPLIB_SERVER_REQUEST_TIMEOUT_SECOND 0
+#endif
+
+#ifndef CPPHTTPLIB_SERVER_REQUEST_TIMEOUT_USECOND
+#define CPPHTTPLIB_SERVER_REQUEST_TIMEOUT_USECOND 0
+#endif
+
+#ifndef CPPHTTPLIB_TIMER_WHEEL_TICK_MSECOND
+#define CPPHTTPLIB_TIMER_WHEEL_TICK_MSECOND 100
+#endif
+
 #ifndef CPPHTTPLIB_CLIENT_READ_TIMEOUT_SECOND
 #define CPPHTTPLIB_CLIENT_READ_TIMEOUT_SECOND 300
 #endif
@@ -90,6 +110,10 @@
 #define CPPHTTPLIB_HEADER_MAX_LENGTH 8192
 #endif
 
+#ifndef CPPHTTPLIB_HEADER_MAX_COUNT
+#define CPPHTTPLIB_HEADER_MAX_COUNT 100
+#endif
+
 #ifndef CPPHTTPLIB_REDIRECT_MAX_COUNT
 #define CPPHTTPLIB_REDIRECT_MAX_COUNT 20
 #endif
@@ -149,6 +173,12 @@
 #define CPPHTTPLIB_MAX_LINE_LENGTH 32768
 #endif
 
+// Fields reserved on the first insert into a Headers (one heap allocation
+// for the fields and one for their hashes, instead of regrowing both)
+#ifndef CPPHTTPLIB_HEADERS_RESERVE
+#define CPPHTTPLIB_HEADERS_RESERVE 16
+#endif
+
 /*
  * Headers
  */
@@ -270,6 +300,11 @@ using socket_t = int;
 #include <unordered_set>
 #include <utility>
 
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#define CPPHTTPLIB_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
 #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
 #ifdef _WIN32
 #include <wincrypt.h>
@@ -389,6 +424,13 @@ inline bool equal(const std::string &a, const std::string &b) {
          });
 }
 
+inline bool equal(const std::string &a, const char *b) {
+  for (size_t i = 0; i < a.size(); i++) {
+    if (!b[i] || to_lower(a[i]) != to_lower(b[i])) { return false; }
+  }
+  return !b[a.size()];
+}
+
 struct equal_to {
   bool operator()(const std::string &a, const std::string &b) const {
     return equal(a, b);
@@ -411,6 +453,23 @@ struct hash {
   }
 };
 
+// Compile-time counterpart of hash for ASCII names, used for case labels.
+// It agrees with hash::hash_core because to_lower() only differs from ASCII
+// lowering outside the ASCII range.
+inline constexpr size_t hash_ascii(const char *s, size_t l, size_t h) {
+  return (l == 0) ? h
+                  : hash_ascii(s + 1, l - 1,
+                               (((std::numeric_limits<size_t>::max)() >> 6) &
+                                h * 33) ^
+                                   static_cast<unsigned char>(
+                                       ('A' <= *s && *s <= 'Z') ? *s + 32
+                                                                : *s));
+}
+
+template <size_t N> inline constexpr size_t hash_lit(const char (&s)[N]) {
+  return hash_ascii(s, N - 1, 0);
+}
+
 } // namespace case_ignore
 
 // This is based on
@@ -527,11 +586,410 @@ enum StatusCode {
   NetworkAuthenticationRequired_511 = 511,
 };
 
-using Headers =
-    std::unordered_multimap<std::string, std::string, detail::case_ignore::hash,
-                            detail::case_ignore::equal_to>;
+enum class Method {
+  Unknown = 0,
+  Get,
+  Head,
+  Post,
+  Put,
+  Delete,
+  Connect,
+  Options,
+  Trace,
+  Patch,
+  Pri,
+};
+
+// Header fields the library itself inspects. Headers interns these names
+// when a field is inserted, so checks like has_header(HeaderId::ContentType)
+// compare a byte instead of hashing and comparing the name again.
+enum class HeaderId : unsigned char {
+  Unknown = 0,
+  Accept,
+  AcceptEncoding,
+  AcceptRanges,
+  Authorization,
+  CacheControl,
+  Connection,
+  ContentEncoding,
+  ContentLength,
+  ContentType,
+  Cookie,
+  ETag,
+  Expect,
+  Host,
+  IfNoneMatch,
+  KeepAlive,
+  Location,
+  ProxyAuthorization,
+  Range,
+  SetCookie,
+  TransferEncoding,
+  UserAgent,
+};
+
+namespace detail {
+
+inline const char *header_name(HeaderId id) {
+  switch (id) {
+  case HeaderId::Accept: return "Accept";
+  case HeaderId::AcceptEncoding: return "Accept-Encoding";
+  case HeaderId::AcceptRanges: return "Accept-Ranges";
+  case HeaderId::Authorization: return "Authorization";
+  case HeaderId::CacheControl: return "Cache-Control";
+  case HeaderId::Connection: return "Connection";
+  case HeaderId::ContentEncoding: return "Content-Encoding";
+  case HeaderId::ContentLength: return "Content-Length";
+  case HeaderId::ContentType: return "Content-Type";
+  case HeaderId::Cookie: return "Cookie";
+  case HeaderId::ETag: return "ETag";
+  case HeaderId::Expect: return "Expect";
+  case HeaderId::Host: return "Host";
+  case HeaderId::IfNoneMatch: return "If-None-Match";
+  case HeaderId::KeepAlive: return "Keep-Alive";
+  case HeaderId::Location: return "Location";
+  case HeaderId::ProxyAuthorization: return "Proxy-Authorization";
+  case HeaderId::Range: return "Range";
+  case HeaderId::SetCookie: return "Set-Cookie";
+  case HeaderId::TransferEncoding: return "Transfer-Encoding";
+  case HeaderId::UserAgent: return "User-Agent";
+  default: return "";
+  }
+}
+
+// `h` is the case-insensitive hash of `key`. The hash picks the candidate and
+// a single name comparison confirms it.
+inline HeaderId header_id_of(const std::string &key, size_t h) {
+  using case_ignore::hash_lit;
+
+  HeaderId id;
+  switch (h) {
+  case hash_lit("Accept"): id = HeaderId::Accept; break;
+  case hash_lit("Accept-Encoding"): id = HeaderId::AcceptEncoding; break;
+  case hash_lit("Accept-Ranges"): id = HeaderId::AcceptRanges; break;
+  case hash_lit("Authorization"): id = HeaderId::Authorization; break;
+  case hash_lit("Cache-Control"): id = HeaderId::CacheControl; break;
+  case hash_lit("Connection"): id = HeaderId::Connection; break;
+  case hash_lit("Content-Encoding"): id = HeaderId::ContentEncoding; break;
+  case hash_lit("Content-Length"): id = HeaderId::ContentLength; break;
+  case hash_lit("Content-Type"): id = HeaderId::ContentType; break;
+  case hash_lit("Cookie"): id = HeaderId::Cookie; break;
+  case hash_lit("ETag"): id = HeaderId::ETag; break;
+  case hash_lit("Expect"): id = HeaderId::Expect; break;
+  case hash_lit("Host"): id = HeaderId::Host; break;
+  case hash_lit("If-None-Match"): id = HeaderId::IfNoneMatch; break;
+  case hash_lit("Keep-Alive"): id = HeaderId::KeepAlive; break;
+  case hash_lit("Location"): id = HeaderId::Location; break;
+  case hash_lit("Proxy-Authorization"):
+    id = HeaderId::ProxyAuthorization;
+    break;
+  case hash_lit("Range"): id = HeaderId::Range; break;
+  case hash_lit("Set-Cookie"): id = HeaderId::SetCookie; break;
+  case hash_lit("Transfer-Encoding"): id = HeaderId::TransferEncoding; break;
+  case hash_lit("User-Agent"): id = HeaderId::UserAgent; break;
+  default: return HeaderId::Unknown;
+  }
+  return case_ignore::equal(key, header_name(id)) ? id : HeaderId::Unknown;
+}
+
+} // namespace detail
+
+// HTTP header fields. Typical messages carry 8-20 fields, so they are kept in
+// a flat vector together with each name's case-insensitive hash: a lookup
+// hashes the key once and then scans contiguous hashes instead of chasing
+// hash-node pointers. Fields keep their arrival order and fields with the same
+// name stay adjacent, so equal_range() works as with std::unordered_multimap.
+// Well-known names are also interned as a HeaderId on insertion. Iterators
+// are read-only so a name cannot change behind its cached hash; use erase()
+// and emplace() to rewrite a field. A 256-bit filter over the name hashes
+// lets emplace() append a new name without scanning the existing ones;
+// read_headers() also stops at CPPHTTPLIB_HEADER_MAX_COUNT fields, which
+// bounds the scans when names are chosen to collide in the filter.
+class Headers {
+public:
+  using key_type = std::string;
+  using mapped_type = std::string;
+  using value_type = std::pair<std::string, std::string>;
+  using container_type = std::vector<value_type>;
+  using iterator = container_type::const_iterator;
+  using const_iterator = container_type::const_iterator;
+  using size_type = container_type::size_type;
+
+  Headers() = default;
+  Headers(std::initializer_list<value_type> init) {
+    insert(init.begin(), init.end());
+  }
+  template <typename It> Headers(It first, It last) { insert(first, last); }
+
+  const_iterator begin() const { return items_.begin(); }
+  const_iterator end() const { return items_.end(); }
+  const_iterator cbegin() const { return items_.cbegin(); }
+  const_iterator cend() const { return items_.cend(); }
+
+  bool empty() const { return items_.empty(); }
+  size_type size() const { return items_.size(); }
+  void clear() {
+    items_.clear();
+    slots_.clear();
+    names_.fill(0);
+  }
+  void reserve(size_type n) {
+    items_.reserve(n);
+    slots_.reserve(n);
+  }
+
+  template <typename K, typename V> iterator emplace(K &&key, V &&val) {
+    std::string k(std::forward<K>(key));
+    auto h = hash_of(k);
+    if (items_.empty()) { reserve(CPPHTTPLIB_HEADERS_RESERVE); }
+
+    // Append after the last field with the same name to keep groups adjacent.
+    auto pos = items_.size();
+    auto i = index_of(k, h);
+    if (i != npos) {
+      pos = i + 1;
+      while (pos < items_.size() && matches(pos, k, h)) {
+        pos++;
+      }
+    }
+
+    names_[(h >> 6) & 3] |= uint64_t(1) << (h & 63);
+    auto offset = static_cast<std::ptrdiff_t>(pos);
+    slots_.insert(slots_.begin() + offset,
+                  slot{h, detail::header_id_of(k, h)});
+    return items_.emplace(items_.begin() + offset, std::move(k),
+                          std::forward<V>(val));
+  }
+
+  template <typename P> iterator insert(P &&kv) {
+    return emplace(std::forward<P>(kv).first, std::forward<P>(kv).second);
+  }
+
+  template <typename It> void insert(It first, It last) {
+    for (; first != last; ++first) {
+      emplace(first->first, first->second);
+    }
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+  iterator erase(const_iterator first, const_iterator last) {
+    auto b = first - items_.cbegin();
+    auto e = last - items_.cbegin();
+    slots_.erase(slots_.begin() + b, slots_.begin() + e);
+    return items_.erase(items_.begin() + b, items_.begin() + e);
+  }
+  size_type erase(const std::string &key) {
+    auto r = equal_range(key);
+    auto n = static_cast<size_type>(std::distance(r.first, r.second));
+    erase(r.first, r.second);
+    return n;
+  }
+
+  const_iterator find(const std::string &key) const {
+    auto i = index_of(key, hash_of(key));
+    return i != npos ? begin() + static_cast<std::ptrdiff_t>(i) : end();
+  }
+
+  std::pair<const_iterator, const_iterator>
+  equal_range(const std::string &key) const {
+    auto r = group_of(key);
+    return std::make_pair(begin() + r.first, begin() + r.second);
+  }
+
+  size_type count(const std::string &key) const {
+    auto r = group_of(key);
+    return static_cast<size_type>(r.second - r.first);
+  }
+
+  const_iterator find(HeaderId id) const {
+    auto i = index_of(id);
+    return i != npos ? begin() + static_cast<std::ptrdiff_t>(i) : end();
+  }
+
+  std::pair<const_iterator, const_iterator> equal_range(HeaderId id) const {
+    auto r = group_of(id);
+    return std::make_pair(begin() + r.first, begin() + r.second);
+  }
+
+private:
+  struct slot {
+    size_t hash;
+    HeaderId id;
+  };
+
+  static const size_type npos = static_cast<size_type>(-1);
+
+  static size_t hash_of(const std::string &key) {
+    return detail::case_ignore::hash()(key);
+  }
+
+  bool matches(size_type i, const std::string &key, size_t h) const {
+    return slots_[i].hash == h &&
+           detail::case_ignore::equal(items_[i].first, key);
+  }
+
+  // False only if no field with this name hash was inserted since clear().
+  bool may_contain(size_t h) const {
+    return (names_[(h >> 6) & 3] >> (h & 63)) & 1;
+  }
+
+  size_type index_of(const std::string &key, size_t h) const {
+    if (!may_contain(h)) { return npos; }
+    for (size_type i = 0; i < slots_.size(); i++) {
+      if (matches(i, key, h)) { return i; }
+    }
+    return npos;
+  }
+
+  size_type index_of(HeaderId id) const {
+    if (id == HeaderId::Unknown) { return npos; }
+    for (size_type i = 0; i < slots_.size(); i++) {
+      if (slots_[i].id == id) { return i; }
+    }
+    return npos;
+  }
+
+  std::pair<std::ptrdiff_t, std::ptrdiff_t> group_of(HeaderId id) const {
+    auto i = index_of(id);
+    if (i == npos) {
+      auto n = static_cast<std::ptrdiff_t>(items_.size());
+      return std::make_pair(n, n);
+    }
+    auto j = i + 1;
+    while (j < slots_.size() && slots_[j].id == id) {
+      j++;
+    }
+    return std::make_pair(static_cast<std::ptrdiff_t>(i),
+                          static_cast<std::ptrdiff_t>(j));
+  }
+
+  std::pair<std::ptrdiff_t, std::ptrdiff_t>
+  group_of(const std::string &key) const {
+    auto h = hash_of(key);
+    auto i = index_of(key, h);
+    if (i == npos) {
+      auto n = static_cast<std::ptrdiff_t>(items_.size());
+      return std::make_pair(n, n);
+    }
+    auto j = i + 1;
+    while (j < items_.size() && matches(j, key, h)) {
+      j++;
+    }
+    return std::make_pair(static_cast<std::ptrdiff_t>(i),
+                          static_cast<std::ptrdiff_t>(j));
+  }
+
+  container_type items_;
+  std::vector<slot> slots_;
+  std::array<uint64_t, 4> names_{{}};
+};
+
+// Query and form parameters. Kept as a vector sorted by key so that typical
+// requests (a handful of params) are looked up with a binary search over
+// contiguous memory instead of walking multimap nodes. Values with the same
+// key keep their insertion order, as with std::multimap. Iterators are
+// read-only, since rewriting a key in place would break the ordering that
+// lookups rely on; use erase() and emplace() instead.
+class Params {
+public:
+  using key_type = std::string;
+  using mapped_type = std::string;
+  using value_type = std::pair<std::string, std::string>;
+  using container_type = std::vector<value_type>;
+  using iterator = container_type::const_iterator;
+  using const_iterator = container_type::const_iterator;
+  using size_type = container_type::size_type;
+
+  Params() = default;
+  Params(std::initializer_list<value_type> init) {
+    insert(init.begin(), init.end());
+  }
+  template <typename It> Params(It first, It last) { insert(first, last); }
+
+  const_iterator begin() const { return items_.begin(); }
+  const_iterator end() const { return items_.end(); }
+  const_iterator cbegin() const { return items_.cbegin(); }
+  const_iterator cend() const { return items_.cend(); }
+
+  bool empty() const { return items_.empty(); }
+  size_type size() const { return items_.size(); }
+  void clear() { items_.clear(); }
+  void reserve(size_type n) { items_.reserve(n); }
+
+  template <typename K, typename V> iterator emplace(K &&key, V &&val) {
+    auto pos = upper_bound(key);
+    return items_.emplace(pos, std::forward<K>(key), std::forward<V>(val));
+  }
+
+  iterator insert(const value_type &kv) { return emplace(kv.first, kv.second); }
+  iterator insert(value_type &&kv) {
+    return emplace(std::move(kv.first), std::move(kv.second));
+  }
+
+  // Appends the whole range and restores the ordering with a single merge, so
+  // bulk loads stay O(n log n) instead of O(n^2) element moves. A few items
+  // are placed one by one instead, which needs no temporary buffers.
+  template <typename It> void insert(It first, It last) {
+    auto mid = static_cast<std::ptrdiff_t>(items_.size());
+    items_.insert(items_.end(), first, last);
+    if (items_.size() - static_cast<size_type>(mid) <= 8) {
+      for (auto it = items_.begin() + mid; it != items_.end(); ++it) {
+        std::rotate(std::upper_bound(items_.begin(), it, *it, key_less()), it,
+                    std::next(it));
+      }
+      return;
+    }
+    std::stable_sort(items_.begin() + mid, items_.end(), key_less());
+    std::inplace_merge(items_.begin(), items_.begin() + mid, items_.end(),
+                       key_less());
+  }
+
+  iterator erase(const_iterator pos) { return items_.erase(pos); }
+  size_type erase(const std::string &key) {
+    auto r = equal_range(key);
+    auto n = static_cast<size_type>(std::distance(r.first, r.second));
+    items_.erase(r.first, r.second);
+    return n;
+  }
+
+  const_iterator find(const std::string &key) const {
+    auto it = lower_bound(key);
+    return (it != items_.end() && it->first == key) ? it : items_.end();
+  }
+
+  std::pair<const_iterator, const_iterator>
+  equal_range(const std::string &key) const {
+    return std::equal_range(items_.cbegin(), items_.cend(), key, key_less());
+  }
+
+  size_type count(const std::string &key) const {
+    auto r = equal_range(key);
+    return static_cast<size_type>(std::distance(r.first, r.second));
+  }
+
+  const_iterator lower_bound(const std::string &key) const {
+    return std::lower_bound(items_.cbegin(), items_.cend(), key, key_less());
+  }
+  const_iterator upper_bound(const std::string &key) const {
+    return std::upper_bound(items_.cbegin(), items_.cend(), key, key_less());
+  }
+
+private:
+  struct key_less {
+    bool operator()(const value_type &a, const value_type &b) const {
+      return a.first < b.first;
+    }
+    bool operator()(const value_type &a, const std::string &b) const {
+      return a.first < b;
+    }
+    bool operator()(const std::string &a, const value_type &b) const {
+      return a < b.first;
+    }
+  };
+
+  container_type items_;
+};
 
-using Params = std::multimap<std::string, std::string>;
 using Match = std::smatch;
 
 using Progress = std::function<bool(uint64_t current, uint64_t total)>;
@@ -633,6 +1091,34 @@ public:
 using Range = std::pair<ssize_t, ssize_t>;
 using Ranges = std::vector<Range>;
 
+// One `name=value` pair of the request's Cookie header, stored as offsets into
+// the header value so that the parsed cookies never copy it.
+struct CookieSlice {
+  size_t name_pos = 0;
+  size_t name_len = 0;
+  size_t value_pos = 0;
+  size_t value_len = 0;
+};
+using Cookies = std::vector<CookieSlice>;
+
+// A cookie set by a response. When the response is written, each cookie
+// becomes a Set-Cookie field handed to the header writer with the other
+// headers, in the order they were added, after any Set-Cookie fields in the
+// headers. A cookie is dropped if its name is not a
+// token, its value not RFC 6265 cookie-octets (optionally in DQUOTEs), its
+// Path or Domain holds ';', ',' or control characters, or its SameSite is
+// not one of the three values below.
+struct SetCookie {
+  std::string name;
+  std::string value;
+  std::string path;
+  std::string domain;
+  long long max_age = -1; // seconds; negative leaves Max-Age out
+  bool secure = false;
+  bool http_only = false;
+  std::string same_site; // "Strict", "Lax", "None", or empty to leave out
+};
+
 struct Request {
   std::string method;
   std::string path;
@@ -651,6 +1137,7 @@ struct Request {
   std::string target;
   MultipartFormDataMap files;
   Ranges ranges;
+  Cookies cookies;
   Match matches;
   std::unordered_map<std::string, std::string> path_params;
   std::function<bool()> is_connection_closed = []() { return true; };
@@ -664,10 +1151,15 @@ struct Request {
 #endif
 
   bool has_header(const std::string &key) const;
+  bool has_header(HeaderId field) const;
   std::string get_header_value(const std::string &key, const char *def = "",
                                size_t id = 0) const;
+  std::string get_header_value(HeaderId field, const char *def = "",
+                               size_t id = 0) const;
   uint64_t get_header_value_u64(const std::string &key, uint64_t def = 0,
                                 size_t id = 0) const;
+  uint64_t get_header_value_u64(HeaderId field, uint64_t def = 0,
+                                size_t id = 0) const;
   size_t get_header_value_count(const std::string &key) const;
   void set_header(const std::string &key, const std::string &val);
 
@@ -675,6 +1167,10 @@ struct Request {
   std::string get_param_value(const std::string &key, size_t id = 0) const;
   size_t get_param_value_count(const std::string &key) const;
 
+  bool has_cookie(const std::string &name) const;
+  std::string get_cookie_value(const std::string &name) const;
+  const char *get_cookie_value(const std::string &name, size_t &len) const;
+
   bool is_multipart_form_data() const;
 
   bool has_file(const std::string &key) const;
@@ -689,6 +1185,7 @@ struct Request {
   size_t authorization_count_ = 0;
   std::chrono::time_point<std::chrono::steady_clock> start_time_ =
       (std::chrono::steady_clock::time_point::min)();
+  Method method_id_ = Method::Unknown;
 };
 
 struct Response {
@@ -698,15 +1195,24 @@ struct Response {
   Headers headers;
   std::string body;
   std::string location; // Redirect location
+  std::vector<SetCookie> cookies;
 
   bool has_header(const std::string &key) const;
+  bool has_header(HeaderId field) const;
   std::string get_header_value(const std::string &key, const char *def = "",
                                size_t id = 0) const;
+  std::string get_header_value(HeaderId field, const char *def = "",
+                               size_t id = 0) const;
   uint64_t get_header_value_u64(const std::string &key, uint64_t def = 0,
                                 size_t id = 0) const;
+  uint64_t get_header_value_u64(HeaderId field, uint64_t def = 0,
+                                size_t id = 0) const;
   size_t get_header_value_count(const std::string &key) const;
   void set_header(const std::string &key, const std::string &val);
 
+  // Adds a cookie; set its attributes through the returned reference
+  SetCookie &add_cookie(const std::string &name, const std::string &value);
+
   void set_redirect(const std::string &url, int status = StatusCode::Found_302);
   void set_content(const char *s, size_t n, const std::string &content_type);
   void set_content(const std::string &s, const std::string &content_type);
@@ -749,6 +1255,55 @@ struct Response {
   std::string file_content_content_type_;
 };
 
+struct TemplateValue {
+  TemplateValue(const std::string &s) : data(s.data()), size(s.size()) {}
+  TemplateValue(const char *s) : data(s), size(strlen(s)) {}
+
+  const char *data;
+  size_t size;
+};
+
+// A page template, parsed once into literal slices and placeholders.
+//
+//   {{name}}    value escaped for where it appears: HTML text, or a tag
+//               attribute (every non-alphanumeric ASCII byte as &#xHH;)
+//   {{{name}}}  value inserted verbatim
+//
+// `fields` lists the placeholder names; render() takes the values in the
+// same order and must get one value per field. An unknown or unterminated
+// placeholder, or a render() call with the wrong number of values, throws
+// std::invalid_argument. Without exceptions the template is marked invalid
+// instead, and an invalid template or a mismatched render() produces nothing.
+class Template {
+public:
+  Template() = default;
+  Template(const std::string &source,
+           std::initializer_list<const char *> fields);
+
+  bool is_valid() const;
+
+  std::string render(std::initializer_list<TemplateValue> values) const;
+  // Appends to `out`, so a caller can reuse one buffer across renders
+  void render(std::string &out,
+              std::initializer_list<TemplateValue> values) const;
+
+private:
+  enum class Escape { None, Html, Attribute };
+
+  struct Piece {
+    size_t offset; // literal: slice of source_
+    size_t length;
+    size_t field; // npos for literal pieces
+    Escape escape;
+  };
+
+  std::string source_;
+  std::vector<Piece> pieces_;
+  size_t field_count_ = 0;
+  size_t literal_size_ = 0;
+  bool valid_ = false;
+};
+
 class Stream {
 public:
   virtual ~Stream() = default;
@@ -958,8 +1513,35 @@ private:
   std::regex regex_;
 };
 
+// Extension to MIME type table used for static files. The built-in types and
+// the user's overrides are merged into one open-addressed array keyed by
+// str2tag, built whenever the mapping changes and read-only afterwards, so a
+// lookup neither allocates nor walks a tree.
+class mime_table {
+public:
+  mime_table();
+  explicit mime_table(const std::map<std::string, std::string> &user_data);
+
+  // Returns the MIME type for `ext` or nullptr if it is unknown.
+  const char *find(const char *ext, size_t len) const;
+
+private:
+  struct slot {
+    unsigned int tag = 0;
+    std::string ext;
+    std::string mime;
+  };
+
+  void add(const std::string &ext, const std::string &mime);
+
+  std::vector<slot> slots_;
+  size_t mask_ = 0;
+};
+
 ssize_t write_headers(Stream &strm, const Headers &headers);
 
+class connection_watchdog;
+
 } // namespace detail
 
 class Server {
@@ -1050,6 +1632,20 @@ public:
   template <class Rep, class Period>
   Server &set_idle_interval(const std::chrono::duration<Rep, Period> &duration);
 
+  // Absolute deadlines, unlike the per-recv read timeout: the request line
+  // and headers must arrive within the header timeout, and the whole request
+  // must be handled within the request timeout. Expired connections are shut
+  // down by a single watchdog thread. Zero disables a deadline.
+  Server &set_header_timeout(time_t sec, time_t usec = 0);
+  template <class Rep, class Period>
+  Server &
+  set_header_timeout(const std::chrono::duration<Rep, Period> &duration);
+
+  Server &set_request_timeout(time_t sec, time_t usec = 0);
+  template <class Rep, class Period>
+  Server &
+  set_request_timeout(const std::chrono::duration<Rep, Period> &duration);
+
   Server &set_payload_max_length(size_t length);
 
   bool bind_to_port(const std::string &host, int port, int socket_flags = 0);
@@ -1081,7 +1677,12 @@ protected:
   time_t write_timeout_usec_ = CPPHTTPLIB_SERVER_WRITE_TIMEOUT_USECOND;
   time_t idle_interval_sec_ = CPPHTTPLIB_IDLE_INTERVAL_SECOND;
   time_t idle_interval_usec_ = CPPHTTPLIB_IDLE_INTERVAL_USECOND;
+  time_t header_timeout_sec_ = CPPHTTPLIB_SERVER_HEADER_TIMEOUT_SECOND;
+  time_t header_timeout_usec_ = CPPHTTPLIB_SERVER_HEADER_TIMEOUT_USECOND;
+  time_t request_timeout_sec_ = CPPHTTPLIB_SERVER_REQUEST_TIMEOUT_SECOND;
+  time_t request_timeout_usec_ = CPPHTTPLIB_SERVER_REQUEST_TIMEOUT_USECOND;
   size_t payload_max_length_ = CPPHTTPLIB_PAYLOAD_MAX_LENGTH;
+  std::unique_ptr<detail::connection_watchdog> watchdog_;
 
 private:
   using Handlers =
@@ -1146,6 +1747,7 @@ private:
   };
   std::vector<MountPointEntry> base_dirs_;
   std::map<std::string, std::string> file_extension_and_mimetype_map_;
+  detail::mime_table mime_table_;
   std::string default_file_mimetype_ = "application/octet-stream";
   Handler file_request_handler_;
 
@@ -1179,6 +1781,145 @@ private:
       detail::write_headers;
 };
 
+// Handler middleware: caps how many requests run the wrapped handlers at
+// once. Up to `max_queue` further requests wait for a slot (at most
+// `max_wait`, if non-zero); any beyond that are answered with 503. When the
+// handler sets a content provider, the slot is held until streaming ends.
+// Running and waiting requests each occupy a server worker thread, so
+// `max_concurrent + max_queue` must stay well below the thread pool size,
+// or the limited route starves every other route. The limiter must outlive
+// the server.
+class ConcurrencyLimiter {
+public:
+  ConcurrencyLimiter(size_t max_concurrent, size_t max_queue,
+                     std::chrono::milliseconds max_wait =
+                         std::chrono::milliseconds::zero());
+
+  ConcurrencyLimiter(const ConcurrencyLimiter &) = delete;
+  ConcurrencyLimiter &operator=(const ConcurrencyLimiter &) = delete;
+
+  Server::Handler wrap(Server::Handler handler);
+
+private:
+  bool acquire();
+  void release();
+
+  size_t max_concurrent_;
+  size_t max_queue_;
+  std::chrono::milliseconds max_wait_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  size_t active_ = 0;
+  size_t waiting_ = 0;
+};
+
+// Handler middleware: identical requests that arrive while one is being
+// handled wait for it and receive a copy of its response (singleflight).
+// The default key is method, target and body; routes whose output depends
+// on headers such as Cookie need a custom `key`. Responses that use a
+// content provider cannot be shared, so each waiter then runs the handler
+// itself. The coalescer must outlive the server.
+class RequestCoalescer {
+public:
+  using Key = std::function<std::string(const Request &)>;
+
+  explicit RequestCoalescer(Key key = nullptr);
+
+  RequestCoalescer(const RequestCoalescer &) = delete;
+  RequestCoalescer &operator=(const RequestCoalescer &) = delete;
+
+  Server::Handler wrap(Server::Handler handler);
+
+private:
+  struct Flight {
+    bool done = false;
+    bool shared = false;
+    int status = -1;
+    std::string reason;
+    Headers headers;
+    std::vector<SetCookie> cookies;
+    std::string body;
+    std::string location;
+  };
+
+  Key key_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::unordered_map<std::string, std::shared_ptr<Flight>> flights_;
+};
+
+// Handler middleware: keeps complete GET responses in memory, keyed on the
+// request path and query parameters (or a custom `key`), so repeated
+// requests skip the handler. Entries live for `ttl`, or less if the handler
+// sends a shorter Cache-Control max-age, and the least recently used ones
+// are evicted to stay within `max_bytes`. Each cached response gets an ETag
+// and, unless the handler chose one, "Cache-Control: no-cache", so clients
+// revalidate with If-None-Match and are answered with 304 when it matches.
+// Responses that are not 200, use a content provider, set cookies or are
+// marked no-store/private are not cached, since they would be replayed to
+// every client; a request with no-cache or no-store bypasses the lookup and
+// refreshes the entry. Other stored headers are replayed as they are. The
+// cache must outlive the server.
+class ResponseCache {
+public:
+  using Key = std::function<std::string(const Request &)>;
+
+  ResponseCache(size_t max_bytes, std::chrono::milliseconds ttl,
+                Key key = nullptr);
+
+  ResponseCache(const ResponseCache &) = delete;
+  ResponseCache &operator=(const ResponseCache &) = delete;
+
+  Server::Handler wrap(Server::Handler handler);
+
+  void clear();
+
+  // The key used without a custom one: the path and each parameter name and
+  // value, every part prefixed with its length so that no decoded value can
+  // forge another parameter list
+  static std::string default_key(const Request &req);
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    std::string key;
+    Headers headers;
+    std::string body;
+    std::string etag;
+    std::string cache_control;
+    Clock::time_point expires;
+    size_t bytes = 0;
+  };
+  using EntryPtr = std::shared_ptr<const Entry>;
+
+  struct Shard {
+    std::mutex mutex;
+    std::list<EntryPtr> lru; // most recently used first
+    std::unordered_map<std::string, std::list<EntryPtr>::iterator> index;
+    size_t bytes = 0;
+  };
+
+  static const size_t shard_count = 16;
+
+  Shard &shard_for(const std::string &key);
+  EntryPtr find(const std::string &key);
+  EntryPtr store(std::string key, const Response &res);
+  static void remove(Shard &shard, std::list<EntryPtr>::iterator it);
+
+  static std::string make_etag(const std::string &body);
+  static bool etag_matches(const std::string &if_none_match,
+                           const std::string &etag);
+  static bool find_directive(const std::string &cache_control,
+                             const char *name, std::string &arg);
+
+  size_t shard_budget_;
+  std::chrono::milliseconds ttl_;
+  Key key_;
+  std::array<Shard, shard_count> shards_;
+};
+
 enum class Error {
   Success = 0,
   Unknown,
@@ -2087,9 +2828,10 @@ inline bool is_numeric(const std::string &str) {
                      [](unsigned char c) { return std::isdigit(c); });
 }
 
-inline uint64_t get_header_value_u64(const Headers &headers,
-                                     const std::string &key, uint64_t def,
-                                     size_t id, bool &is_invalid_value) {
+template <typename K>
+inline uint64_t get_header_value_u64(const Headers &headers, const K &key,
+                                     uint64_t def, size_t id,
+                                     bool &is_invalid_value) {
   is_invalid_value = false;
   auto rng = headers.equal_range(key);
   auto it = rng.first;
@@ -2104,9 +2846,9 @@ inline uint64_t get_header_value_u64(const Headers &headers,
   return def;
 }
 
-inline uint64_t get_header_value_u64(const Headers &headers,
-                                     const std::string &key, uint64_t def,
-                                     size_t id) {
+template <typename K>
+inline uint64_t get_header_value_u64(const Headers &headers, const K &key,
+                                     uint64_t def, size_t id) {
   bool dummy = false;
   return get_header_value_u64(headers, key, def, id, dummy);
 }
@@ -2123,6 +2865,16 @@ inline uint64_t Response::get_header_value_u64(const std::string &key,
   return detail::get_header_value_u64(headers, key, def, id);
 }
 
+inline uint64_t Request::get_header_value_u64(HeaderId field, uint64_t def,
+                                              size_t id) const {
+  return detail::get_header_value_u64(headers, field, def, id);
+}
+
+inline uint64_t Response::get_header_value_u64(HeaderId field, uint64_t def,
+                                               size_t id) const {
+  return detail::get_header_value_u64(headers, field, def, id);
+}
+
 namespace detail {
 
 inline bool set_socket_opt_impl(socket_t sock, int level, int optname,
@@ -2273,6 +3025,24 @@ Server::set_idle_interval(const std::chrono::duration<Rep, Period> &duration) {
   return *this;
 }
 
+template <class Rep, class Period>
+inline Server &
+Server::set_header_timeout(const std::chrono::duration<Rep, Period> &duration) {
+  detail::duration_to_sec_and_usec(
+      duration,
+      [&](time_t sec, time_t usec) { set_header_timeout(sec, usec); });
+  return *this;
+}
+
+template <class Rep, class Period>
+inline Server &Server::set_request_timeout(
+    const std::chrono::duration<Rep, Period> &duration) {
+  detail::duration_to_sec_and_usec(duration, [&](time_t sec, time_t usec) {
+    set_request_timeout(sec, usec);
+  });
+  return *this;
+}
+
 inline std::string to_string(const Error error) {
   switch (error) {
   case Error::Success: return "Success (no error)";
@@ -2378,6 +3148,10 @@ std::string append_query_params(const std::string &path, const Params &params);
 
 std::pair<std::string, std::string> make_range_header(const Ranges &ranges);
 
+std::string escape_html(const std::string &s);
+
+std::string escape_html_attribute(const std::string &s);
+
 std::pair<std::string, std::string>
 make_basic_authentication_header(const std::string &username,
                                  const std::string &password,
@@ -2417,6 +3191,10 @@ private:
 
 std::string encode_query_param(const std::string &value);
 
+void escape_html(const char *s, size_t n, std::string &out);
+
+void escape_html_attribute(const char *s, size_t n, std::string &out);
+
 std::string decode_url(const std::string &s, bool convert_plus_to_space);
 
 std::string trim_copy(const std::string &s);
@@ -2457,6 +3235,9 @@ socket_t create_client_socket(const std::string &host, const std::string &ip,
 const char *get_header_value(const Headers &headers, const std::string &key,
                              const char *def, size_t id);
 
+const char *get_header_value(const Headers &headers, HeaderId field,
+                             const char *def, size_t id);
+
 std::string params_to_query_str(const Params &params);
 
 void parse_query_text(const char *data, std::size_t size, Params &params);
@@ -2468,6 +3249,8 @@ bool parse_multipart_boundary(const std::string &content_type,
 
 bool parse_range_header(const std::string &s, Ranges &ranges);
 
+void parse_cookie_header(const std::string &s, Cookies &cookies);
+
 int close_socket(socket_t sock);
 
 ssize_t send_socket(socket_t sock, const void *ptr, size_t size, int flags);
@@ -2724,37 +3507,55 @@ inline bool is_field_value(const std::string &s) { return is_field_content(s); }
 
 namespace detail {
 
+// Returns the value of a hex digit, or -1. Table driven so that the URL
+// decoder does a single load per digit instead of three range checks.
+inline int hex_digit_value(char c) {
+  static const signed char table[256] = {
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+       0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+      -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  };
+  return table[static_cast<unsigned char>(c)];
+}
+
 inline bool is_hex(char c, int &v) {
-  if (0x20 <= c && isdigit(c)) {
-    v = c - '0';
-    return true;
-  } else if ('A' <= c && c <= 'F') {
-    v = c - 'A' + 10;
-    return true;
-  } else if ('a' <= c && c <= 'f') {
-    v = c - 'a' + 10;
-    return true;
-  }
-  return false;
+  auto d = hex_digit_value(c);
+  if (d < 0) { return false; }
+  v = d;
+  return true;
 }
 
-inline bool from_hex_to_i(const std::string &s, size_t i, size_t cnt,
-                          int &val) {
-  if (i >= s.size()) { return false; }
+inline bool from_hex_to_i(const char *b, const char *e, size_t cnt, int &val) {
+  if (static_cast<size_t>(e - b) < cnt) { return false; }
 
   val = 0;
-  for (; cnt; i++, cnt--) {
-    if (!s[i]) { return false; }
-    auto v = 0;
-    if (is_hex(s[i], v)) {
-      val = val * 16 + v;
-    } else {
-      return false;
-    }
+  for (; cnt; b++, cnt--) {
+    auto v = hex_digit_value(*b);
+    if (v < 0) { return false; }
+    val = val * 16 + v;
   }
   return true;
 }
 
+inline bool from_hex_to_i(const std::string &s, size_t i, size_t cnt,
+                          int &val) {
+  if (i >= s.size()) { return false; }
+  return from_hex_to_i(s.data() + i, s.data() + s.size(), cnt, val);
+}
+
 inline std::string from_i_to_hex(size_t n) {
   static const auto charset = "0123456789abcdef";
   std::string ret;
@@ -2884,19 +3685,110 @@ inline bool FileStat::is_dir() const {
   return ret_ >= 0 && S_ISDIR(st_.st_mode);
 }
 
-inline std::string encode_query_param(const std::string &value) {
-  std::ostringstream escaped;
-  escaped.fill('0');
-  escaped << std::hex;
+inline bool is_html_special(char c) {
+  return c == '&' || c == '<' || c == '>' || c == '"' || c == '\'';
+}
 
-  for (auto c : value) {
-    if (std::isalnum(static_cast<uint8_t>(c)) || c == '-' || c == '_' ||
-        c == '.' || c == '!' || c == '~' || c == '*' || c == '\'' || c == '(' ||
-        c == ')') {
-      escaped << c;
-    } else {
-      escaped << std::uppercase;
-      escaped << '%' << std::setw(2)
+// Length of the leading run of `s` that escape_html copies unchanged. With
+// SSE2, 16 bytes are checked per step.
+inline size_t html_clean_prefix(const char *s, size_t n) {
+  size_t i = 0;
+#ifdef CPPHTTPLIB_HAS_SSE2
+  const auto amp = _mm_set1_epi8('&');
+  const auto lt = _mm_set1_epi8('<');
+  const auto gt = _mm_set1_epi8('>');
+  const auto dquote = _mm_set1_epi8('"');
+  const auto squote = _mm_set1_epi8('\'');
+  for (; i + 16 <= n; i += 16) {
+    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+    auto m = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, amp), _mm_cmpeq_epi8(v, lt)),
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, gt),
+                                  _mm_cmpeq_epi8(v, dquote)),
+                     _mm_cmpeq_epi8(v, squote)));
+    auto mask = _mm_movemask_epi8(m);
+    if (mask) { return i + static_cast<size_t>(__builtin_ctz(mask)); }
+  }
+#endif
+  while (i < n && !is_html_special(s[i])) {
+    i++;
+  }
+  return i;
+}
+
+// & < > " ' as entities; safe in text and in quoted attribute values.
+// Runs without special characters are appended in one copy.
+inline void escape_html(const char *s, size_t n, std::string &out) {
+  out.reserve(out.size() + n);
+  size_t i = 0;
+  while (i < n) {
+    auto run = html_clean_prefix(s + i, n - i);
+    out.append(s + i, run);
+    i += run;
+    if (i == n) { break; }
+
+    switch (s[i++]) {
+    case '&': out += "&amp;"; break;
+    case '<': out += "&lt;"; break;
+    case '>': out += "&gt;"; break;
+    case '"': out += "&quot;"; break;
+    default: out += "&#39;"; break;
+    }
+  }
+}
+
+inline bool is_attribute_safe(unsigned char c) {
+  return c >= 0x80 || static_cast<unsigned char>((c | 0x20) - 'a') < 26 ||
+         static_cast<unsigned char>(c - '0') < 10;
+}
+
+// Every ASCII byte except alphanumerics as &#xHH;, which is safe even in an
+// unquoted attribute value. UTF-8 sequences are passed through. Attribute
+// values are usually short and punctuated every few bytes, so instead of
+// copying runs this sizes the output in one pass and fills it in a second.
+inline void escape_html_attribute(const char *s, size_t n, std::string &out) {
+  static const char hex[] = "0123456789ABCDEF";
+  size_t escaped = 0;
+  for (size_t i = 0; i < n; i++) {
+    escaped += !is_attribute_safe(static_cast<unsigned char>(s[i]));
+  }
+
+  auto pos = out.size();
+  out.resize(pos + n + escaped * 5);
+  auto p = &out[pos];
+  if (escaped == 0) {
+    memcpy(p, s, n);
+    return;
+  }
+  for (size_t i = 0; i < n; i++) {
+    auto c = static_cast<unsigned char>(s[i]);
+    if (is_attribute_safe(c)) {
+      *p++ = static_cast<char>(c);
+    } else {
+      p[0] = '&';
+      p[1] = '#';
+      p[2] = 'x';
+      p[3] = hex[c >> 4];
+      p[4] = hex[c & 0xf];
+      p[5] = ';';
+      p += 6;
+    }
+  }
+}
+
+inline std::string encode_query_param(const std::string &value) {
+  std::ostringstream escaped;
+  escaped.fill('0');
+  escaped << std::hex;
+
+  for (auto c : value) {
+    if (std::isalnum(static_cast<uint8_t>(c)) || c == '-' || c == '_' ||
+        c == '.' || c == '!' || c == '~' || c == '*' || c == '\'' || c == '(' ||
+        c == ')') {
+      escaped << c;
+    } else {
+      escaped << std::uppercase;
+      escaped << '%' << std::setw(2)
               << static_cast<int>(static_cast<unsigned char>(c));
       escaped << std::nouppercase;
     }
@@ -2937,48 +3829,104 @@ inline std::string encode_url(const std::string &s) {
   return result;
 }
 
-inline std::string decode_url(const std::string &s,
-                              bool convert_plus_to_space) {
-  std::string result;
+// Finds the next byte that the URL decoder has to rewrite. memchr is
+// vectorized by every libc we target, so clean runs are skipped at close to
+// memory bandwidth. The two candidate positions are cached by the caller and
+// only refreshed once passed, which keeps the whole scan linear.
+inline const char *find_url_escape(const char *b, const char *e, char c) {
+  auto p = static_cast<const char *>(
+      std::memchr(b, c, static_cast<size_t>(e - b)));
+  return p ? p : e;
+}
+
+// Decodes percent escapes (and '+' when requested) in place and returns the
+// decoded length. Every escape is at least as long as what it decodes to, so
+// the output never overtakes the input and no buffer is allocated.
+inline size_t decode_url_inplace(char *s, size_t n,
+                                 bool convert_plus_to_space) {
+  const char *in = s;
+  const char *end = s + n;
+  char *out = s;
+
+  auto next_pct = find_url_escape(in, end, '%');
+  auto next_plus = convert_plus_to_space ? find_url_escape(in, end, '+') : end;
+
+  while (in < end) {
+    if (next_pct < in) { next_pct = find_url_escape(in, end, '%'); }
+    if (next_plus < in) { next_plus = find_url_escape(in, end, '+'); }
+
+    auto next = (std::min)(next_pct, next_plus);
+    if (next != in) {
+      auto len = static_cast<size_t>(next - in);
+      if (out != in) { std::memmove(out, in, len); }
+      out += len;
+      in = next;
+      if (in == end) { break; }
+    }
+
+    if (*in == '+') {
+      *out++ = ' ';
+      in++;
+      continue;
+    }
 
-  for (size_t i = 0; i < s.size(); i++) {
-    if (s[i] == '%' && i + 1 < s.size()) {
-      if (s[i + 1] == 'u') {
-        auto val = 0;
-        if (from_hex_to_i(s, i + 2, 4, val)) {
-          // 4 digits Unicode codes
-          char buff[4];
-          size_t len = to_utf8(val, buff);
-          if (len > 0) { result.append(buff, len); }
-          i += 5; // 'u0000'
-        } else {
-          result += s[i];
-        }
-      } else {
-        auto val = 0;
-        if (from_hex_to_i(s, i + 1, 2, val)) {
-          // 2 digits hex codes
-          result += static_cast<char>(val);
-          i += 2; // '00'
-        } else {
-          result += s[i];
-        }
+    auto val = 0;
+    if (in + 1 < end && in[1] == 'u') {
+      if (from_hex_to_i(in + 2, end, 4, val)) {
+        // 4 digits Unicode codes
+        char buff[4];
+        auto len = to_utf8(val, buff);
+        std::memcpy(out, buff, len);
+        out += len;
+        in += 6; // '%u0000'
+        continue;
       }
-    } else if (convert_plus_to_space && s[i] == '+') {
-      result += ' ';
-    } else {
-      result += s[i];
+    } else if (from_hex_to_i(in + 1, end, 2, val)) {
+      // 2 digits hex codes
+      *out++ = static_cast<char>(val);
+      in += 3; // '%00'
+      continue;
     }
+
+    *out++ = *in++;
   }
 
+  return static_cast<size_t>(out - s);
+}
+
+inline void decode_url_inplace(std::string &s, bool convert_plus_to_space) {
+  if (s.empty()) { return; }
+  s.resize(decode_url_inplace(&s[0], s.size(), convert_plus_to_space));
+}
+
+inline std::string decode_url(const std::string &s,
+                              bool convert_plus_to_space) {
+  auto result = s;
+  decode_url_inplace(result, convert_plus_to_space);
   return result;
 }
 
+// Returns the offset of the extension matched by "\.([a-zA-Z0-9]+)$", or
+// std::string::npos if there is none.
+inline size_t file_extension_pos(const std::string &path) {
+  auto dot = path.rfind('.');
+  if (dot == std::string::npos || dot + 1 == path.size()) {
+    return std::string::npos;
+  }
+  for (auto i = dot + 1; i < path.size(); i++) {
+    auto c = path[i];
+    if (!(('0' <= c && c <= '9') || ('A' <= c && c <= 'Z') ||
+          ('a' <= c && c <= 'z'))) {
+      return std::string::npos;
+    }
+  }
+  return dot + 1;
+}
+
 inline std::string file_extension(const std::string &path) {
-  std::smatch m;
-  thread_local auto re = std::regex("\\.([a-zA-Z0-9]+)$");
-  if (std::regex_search(path, m, re)) { return m[1].str(); }
-  return std::string();
+  auto pos = file_extension_pos(path);
+  if (pos == std::string::npos) { return std::string(); }
+  return path.substr(pos);
 }
 
 inline bool is_space_or_tab(char c) { return c == ' ' || c == '\t'; }
@@ -3524,6 +4472,227 @@ inline int shutdown_socket(socket_t sock) {
 #endif
 }
 
+// Hierarchical timing wheel (4 levels of 64 slots) of socket deadlines.
+// Timers live in intrusive lists inside one node vector, so schedule() and
+// cancel() are O(1). A timer sits in the lowest level whose range still
+// contains both its expiry and the current tick; advance() moves the timers
+// of a higher-level slot down only when the level below wraps around.
+class timer_wheel {
+public:
+  using clock = std::chrono::steady_clock;
+
+  timer_wheel(clock::duration tick, clock::time_point origin)
+      : tick_(tick), origin_(origin) {
+    heads_.fill(size_t(npos));
+  }
+
+  size_t schedule(clock::time_point deadline, socket_t sock) {
+    size_t i;
+    if (free_.empty()) {
+      i = nodes_.size();
+      nodes_.emplace_back();
+    } else {
+      i = free_.back();
+      free_.pop_back();
+    }
+    nodes_[i].expiry = to_tick(deadline);
+    nodes_[i].sock = sock;
+    link(i, now_ + 1);
+    count_++;
+    return i;
+  }
+
+  void cancel(size_t i) {
+    unlink(i);
+    free_.push_back(i);
+    count_--;
+  }
+
+  size_t size() const { return count_; }
+
+  // Calls fn(sock) for every timer due at or before `now`. Expired timers are
+  // released before fn runs.
+  template <typename Fn> void advance(clock::time_point now, Fn fn) {
+    auto target = to_tick(now);
+    while (now_ < target) {
+      now_++;
+
+      for (size_t level = 1; level < level_count; level++) {
+        auto shift = level_bits * level;
+        if (now_ & ((uint64_t(1) << shift) - 1)) { break; }
+        auto list = detach(level, (now_ >> shift) & slot_mask);
+        while (list != npos) {
+          auto next = nodes_[list].next;
+          link(list, now_); // Timers due now land in the slot fired below
+          list = next;
+        }
+      }
+
+      auto list = detach(0, now_ & slot_mask);
+      while (list != npos) {
+        auto next = nodes_[list].next;
+        if (nodes_[list].expiry > now_) {
+          link(list, now_ + 1); // Clamped timer that is not due yet
+        } else {
+          auto sock = nodes_[list].sock;
+          free_.push_back(list);
+          count_--;
+          fn(sock);
+        }
+        list = next;
+      }
+    }
+  }
+
+private:
+  static constexpr size_t level_bits = 6;
+  static constexpr size_t level_count = 4;
+  static constexpr size_t slot_count = size_t(1) << level_bits;
+  static constexpr uint64_t slot_mask = slot_count - 1;
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  struct node {
+    uint64_t expiry = 0;
+    socket_t sock = INVALID_SOCKET;
+    size_t head = npos;
+    size_t prev = npos;
+    size_t next = npos;
+  };
+
+  uint64_t to_tick(clock::time_point t) const {
+    if (t <= origin_) { return 0; }
+    return static_cast<uint64_t>((t - origin_) / tick_);
+  }
+
+  void link(size_t i, uint64_t earliest) {
+    auto &n = nodes_[i];
+    auto e = n.expiry > earliest ? n.expiry : earliest;
+
+    // Deadlines beyond the range of the top level wait in the farthest slot
+    // it can still tell apart and are re-linked from there. A nearer
+    // deadline past a 2^24-tick boundary needs no clamping: its top-level
+    // slot comes round again before it is due.
+    const auto span = uint64_t(1) << (level_bits * level_count);
+    if (e - now_ >= span) { e = now_ + span - 1; }
+
+    size_t level = 0;
+    while (level + 1 < level_count &&
+           ((e ^ now_) >> (level_bits * (level + 1)))) {
+      level++;
+    }
+
+    auto head = level * slot_count + ((e >> (level_bits * level)) & slot_mask);
+    n.head = head;
+    n.prev = npos;
+    n.next = heads_[head];
+    if (n.next != npos) { nodes_[n.next].prev = i; }
+    heads_[head] = i;
+  }
+
+  void unlink(size_t i) {
+    auto &n = nodes_[i];
+    if (n.prev != npos) {
+      nodes_[n.prev].next = n.next;
+    } else {
+      heads_[n.head] = n.next;
+    }
+    if (n.next != npos) { nodes_[n.next].prev = n.prev; }
+    n.prev = n.next = npos;
+  }
+
+  size_t detach(size_t level, uint64_t slot) {
+    auto &head = heads_[level * slot_count + static_cast<size_t>(slot)];
+    auto list = head;
+    head = npos;
+    return list;
+  }
+
+  clock::duration tick_;
+  clock::time_point origin_;
+  uint64_t now_ = 0;
+  size_t count_ = 0;
+  std::vector<node> nodes_;
+  std::vector<size_t> free_;
+  std::array<size_t, slot_count * level_count> heads_;
+};
+
+// Owns the server's timer wheel and the one thread that advances it. Each
+// connection has at most one armed deadline; when it passes, the socket is
+// shut down so that the worker blocked on it returns at once.
+class connection_watchdog {
+public:
+  using clock = timer_wheel::clock;
+
+  connection_watchdog()
+      : wheel_(std::chrono::milliseconds(CPPHTTPLIB_TIMER_WHEEL_TICK_MSECOND),
+               clock::now()),
+        thread_(&connection_watchdog::run, this) {}
+
+  ~connection_watchdog() {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      shutdown_ = true;
+    }
+    cond_.notify_one();
+    thread_.join();
+  }
+
+  connection_watchdog(const connection_watchdog &) = delete;
+  connection_watchdog &operator=(const connection_watchdog &) = delete;
+
+  void arm(socket_t sock, clock::time_point deadline) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      auto it = timers_.find(sock);
+      if (it != timers_.end()) {
+        wheel_.cancel(it->second);
+        it->second = wheel_.schedule(deadline, sock);
+      } else {
+        timers_.emplace(sock, wheel_.schedule(deadline, sock));
+      }
+    }
+    cond_.notify_one();
+  }
+
+  // Must be called before the socket is closed, so that an expiry can never
+  // hit a reused descriptor.
+  void disarm(socket_t sock) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = timers_.find(sock);
+    if (it != timers_.end()) {
+      wheel_.cancel(it->second);
+      timers_.erase(it);
+    }
+  }
+
+private:
+  void run() {
+    const auto tick =
+        std::chrono::milliseconds(CPPHTTPLIB_TIMER_WHEEL_TICK_MSECOND);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!shutdown_) {
+      if (wheel_.size() == 0) {
+        cond_.wait(lock);
+      } else {
+        cond_.wait_for(lock, tick);
+      }
+
+      wheel_.advance(clock::now(), [&](socket_t sock) {
+        timers_.erase(sock);
+        shutdown_socket(sock);
+      });
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool shutdown_ = false;
+  timer_wheel wheel_;
+  std::unordered_map<socket_t, size_t> timers_;
+  std::thread thread_;
+};
+
 inline std::string escape_abstract_namespace_unix_domain(const std::string &s) {
   if (s.size() > 1 && s[0] == '\0') {
     auto ret = s;
@@ -3914,70 +5083,141 @@ inline constexpr unsigned int operator""_t(const char *s, size_t l) {
 
 } // namespace udl
 
-inline std::string
-find_content_type(const std::string &path,
-                  const std::map<std::string, std::string> &user_data,
-                  const std::string &default_content_type) {
-  auto ext = file_extension(path);
+// Maps a request method token to its Method. The tag switch selects the only
+// possible candidate; the string compare rejects hash collisions.
+inline Method method_of(const std::string &s) {
+  using udl::operator""_t;
 
-  auto it = user_data.find(ext);
-  if (it != user_data.end()) { return it->second; }
+  switch (str2tag(s)) {
+  case "GET"_t: return s == "GET" ? Method::Get : Method::Unknown;
+  case "HEAD"_t: return s == "HEAD" ? Method::Head : Method::Unknown;
+  case "POST"_t: return s == "POST" ? Method::Post : Method::Unknown;
+  case "PUT"_t: return s == "PUT" ? Method::Put : Method::Unknown;
+  case "DELETE"_t: return s == "DELETE" ? Method::Delete : Method::Unknown;
+  case "CONNECT"_t: return s == "CONNECT" ? Method::Connect : Method::Unknown;
+  case "OPTIONS"_t: return s == "OPTIONS" ? Method::Options : Method::Unknown;
+  case "TRACE"_t: return s == "TRACE" ? Method::Trace : Method::Unknown;
+  case "PATCH"_t: return s == "PATCH" ? Method::Patch : Method::Unknown;
+  case "PRI"_t: return s == "PRI" ? Method::Pri : Method::Unknown;
+  default: return Method::Unknown;
+  }
+}
+
+inline mime_table::mime_table()
+    : mime_table(std::map<std::string, std::string>()) {}
+
+inline mime_table::mime_table(
+    const std::map<std::string, std::string> &user_data) {
+  static const struct {
+    const char *ext;
+    const char *mime;
+  } builtin[] = {
+      {"css", "text/css"},
+      {"csv", "text/csv"},
+      {"htm", "text/html"},
+      {"html", "text/html"},
+      {"js", "text/javascript"},
+      {"mjs", "text/javascript"},
+      {"txt", "text/plain"},
+      {"vtt", "text/vtt"},
+
+      {"apng", "image/apng"},
+      {"avif", "image/avif"},
+      {"bmp", "image/bmp"},
+      {"gif", "image/gif"},
+      {"png", "image/png"},
+      {"svg", "image/svg+xml"},
+      {"webp", "image/webp"},
+      {"ico", "image/x-icon"},
+      {"tif", "image/tiff"},
+      {"tiff", "image/tiff"},
+      {"jpg", "image/jpeg"},
+      {"jpeg", "image/jpeg"},
+
+      {"mp4", "video/mp4"},
+      {"mpeg", "video/mpeg"},
+      {"webm", "video/webm"},
+
+      {"mp3", "audio/mp3"},
+      {"mpga", "audio/mpeg"},
+      {"weba", "audio/webm"},
+      {"wav", "audio/wave"},
+
+      {"otf", "font/otf"},
+      {"ttf", "font/ttf"},
+      {"woff", "font/woff"},
+      {"woff2", "font/woff2"},
+
+      {"7z", "application/x-7z-compressed"},
+      {"atom", "application/atom+xml"},
+      {"pdf", "application/pdf"},
+      {"json", "application/json"},
+      {"rss", "application/rss+xml"},
+      {"tar", "application/x-tar"},
+      {"xht", "application/xhtml+xml"},
+      {"xhtml", "application/xhtml+xml"},
+      {"xslt", "application/xslt+xml"},
+      {"xml", "application/xml"},
+      {"gz", "application/gzip"},
+      {"zip", "application/zip"},
+      {"wasm", "application/wasm"},
+  };
 
-  using udl::operator""_t;
+  auto n = sizeof(builtin) / sizeof(builtin[0]) + user_data.size();
+  size_t size = 16;
+  while (size < n * 2) {
+    size *= 2;
+  }
+  slots_.resize(size);
+  mask_ = size - 1;
+
+  for (const auto &x : builtin) {
+    add(x.ext, x.mime);
+  }
+  for (const auto &x : user_data) {
+    if (!x.first.empty()) { add(x.first, x.second); }
+  }
+}
 
-  switch (str2tag(ext)) {
-  default: return default_content_type;
-
-  case "css"_t: return "text/css";
-  case "csv"_t: return "text/csv";
-  case "htm"_t:
-  case "html"_t: return "text/html";
-  case "js"_t:
-  case "mjs"_t: return "text/javascript";
-  case "txt"_t: return "text/plain";
-  case "vtt"_t: return "text/vtt";
-
-  case "apng"_t: return "image/apng";
-  case "avif"_t: return "image/avif";
-  case "bmp"_t: return "image/bmp";
-  case "gif"_t: return "image/gif";
-  case "png"_t: return "image/png";
-  case "svg"_t: return "image/svg+xml";
-  case "webp"_t: return "image/webp";
-  case "ico"_t: return "image/x-icon";
-  case "tif"_t: return "image/tiff";
-  case "tiff"_t: return "image/tiff";
-  case "jpg"_t:
-  case "jpeg"_t: return "image/jpeg";
-
-  case "mp4"_t: return "video/mp4";
-  case "mpeg"_t: return "video/mpeg";
-  case "webm"_t: return "video/webm";
-
-  case "mp3"_t: return "audio/mp3";
-  case "mpga"_t: return "audio/mpeg";
-  case "weba"_t: return "audio/webm";
-  case "wav"_t: return "audio/wave";
-
-  case "otf"_t: return "font/otf";
-  case "ttf"_t: return "font/ttf";
-  case "woff"_t: return "font/woff";
-  case "woff2"_t: return "font/woff2";
-
-  case "7z"_t: return "application/x-7z-compressed";
-  case "atom"_t: return "application/atom+xml";
-  case "pdf"_t: return "application/pdf";
-  case "json"_t: return "application/json";
-  case "rss"_t: return "application/rss+xml";
-  case "tar"_t: return "application/x-tar";
-  case "xht"_t:
-  case "xhtml"_t: return "application/xhtml+xml";
-  case "xslt"_t: return "application/xslt+xml";
-  case "xml"_t: return "application/xml";
-  case "gz"_t: return "application/gzip";
-  case "zip"_t: return "application/zip";
-  case "wasm"_t: return "application/wasm";
+inline void mime_table::add(const std::string &ext, const std::string &mime) {
+  auto tag = str2tag(ext);
+  for (auto i = tag & mask_;; i = (i + 1) & mask_) {
+    auto &slot = slots_[i];
+    if (slot.ext.empty()) {
+      slot.tag = tag;
+      slot.ext = ext;
+      slot.mime = mime;
+      return;
+    }
+    if (slot.tag == tag && slot.ext == ext) {
+      slot.mime = mime;
+      return;
+    }
+  }
+}
+
+inline const char *mime_table::find(const char *ext, size_t len) const {
+  if (!len) { return nullptr; }
+  auto tag = str2tag_core(ext, len, 0);
+  for (auto i = tag & mask_;; i = (i + 1) & mask_) {
+    const auto &slot = slots_[i];
+    if (slot.ext.empty()) { return nullptr; }
+    if (slot.tag == tag && slot.ext.size() == len &&
+        !slot.ext.compare(0, len, ext, len)) {
+      return slot.mime.c_str();
+    }
+  }
+}
+
+inline const char *find_content_type(const std::string &path,
+                                     const mime_table &table,
+                                     const std::string &default_content_type) {
+  auto pos = file_extension_pos(path);
+  if (pos != std::string::npos) {
+    auto mime = table.find(path.data() + pos, path.size() - pos);
+    if (mime) { return mime; }
   }
+  return default_content_type.c_str();
 }
 
 inline bool can_compress_content_type(const std::string &content_type) {
@@ -4292,6 +5532,10 @@ inline bool has_header(const Headers &headers, const std::string &key) {
   return headers.find(key) != headers.end();
 }
 
+inline bool has_header(const Headers &headers, HeaderId field) {
+  return headers.find(field) != headers.end();
+}
+
 inline const char *get_header_value(const Headers &headers,
                                     const std::string &key, const char *def,
                                     size_t id) {
@@ -4302,6 +5546,15 @@ inline const char *get_header_value(const Headers &headers,
   return def;
 }
 
+inline const char *get_header_value(const Headers &headers, HeaderId field,
+                                    const char *def, size_t id) {
+  auto rng = headers.equal_range(field);
+  auto it = rng.first;
+  std::advance(it, static_cast<ssize_t>(id));
+  if (it != rng.second) { return it->second.c_str(); }
+  return def;
+}
+
 template <typename T>
 inline bool parse_header(const char *beg, const char *end, T fn) {
   // Skip trailing spaces and tabs.
@@ -4373,6 +5626,7 @@ inline bool read_headers(Stream &strm, Headers &headers) {
     }
 
     if (line_reader.size() > CPPHTTPLIB_HEADER_MAX_LENGTH) { return false; }
+    if (headers.size() >= CPPHTTPLIB_HEADER_MAX_COUNT) { return false; }
 
     // Exclude line terminator
     auto end = line_reader.ptr() + line_reader.size() - line_terminator_len;
@@ -4487,6 +5741,7 @@ inline bool read_content_chunked(Stream &strm, T &x,
 
   while (strcmp(line_reader.ptr(), "\r\n") != 0) {
     if (line_reader.size() > CPPHTTPLIB_HEADER_MAX_LENGTH) { return false; }
+    if (x.headers.size() >= CPPHTTPLIB_HEADER_MAX_COUNT) { return false; }
 
     // Exclude line terminator
     constexpr auto line_terminator_len = 2;
@@ -4639,6 +5894,84 @@ inline ssize_t write_headers(Stream &strm, const Headers &headers) {
   return write_len;
 }
 
+// RFC 6265 cookie-octet: printable ASCII except whitespace, DQUOTE, ',',
+// ';' and backslash
+inline bool is_cookie_octet(char c) {
+  auto u = static_cast<unsigned char>(c);
+  return u == 0x21 || (0x23 <= u && u <= 0x2b) || (0x2d <= u && u <= 0x3a) ||
+         (0x3c <= u && u <= 0x5b) || (0x5d <= u && u <= 0x7e);
+}
+
+// cookie-value: cookie-octets, optionally wrapped in DQUOTEs
+inline bool is_cookie_value(const std::string &s) {
+  auto b = s.begin();
+  auto e = s.end();
+  if (s.size() >= 2 && s.front() == '"' && s.back() == '"') {
+    ++b;
+    --e;
+  }
+  return std::all_of(b, e, is_cookie_octet);
+}
+
+// Path and Domain values: printable ASCII without ';' or ',', which would
+// end the attribute or, for some clients, the cookie
+inline bool is_cookie_attribute_value(const std::string &s) {
+  return std::all_of(s.begin(), s.end(), [](char c) {
+    auto u = static_cast<unsigned char>(c);
+    return 0x20 <= u && u < 0x7f && c != ';' && c != ',';
+  });
+}
+
+inline bool is_same_site_value(const std::string &s) {
+  return s.empty() || s == "Strict" || s == "Lax" || s == "None";
+}
+
+// Appends the Set-Cookie field value for `c` to `buf`, or nothing if the
+// cookie has an invalid name, value, Path, Domain or SameSite
+inline bool append_set_cookie(std::string &buf, const SetCookie &c) {
+  if (!fields::is_token(c.name) || !is_cookie_value(c.value) ||
+      !is_cookie_attribute_value(c.path) ||
+      !is_cookie_attribute_value(c.domain) ||
+      !is_same_site_value(c.same_site)) {
+    return false;
+  }
+
+  buf += c.name;
+  buf += '=';
+  buf += c.value;
+  if (!c.path.empty()) {
+    buf += "; Path=";
+    buf += c.path;
+  }
+  if (!c.domain.empty()) {
+    buf += "; Domain=";
+    buf += c.domain;
+  }
+  if (c.max_age >= 0) {
+    buf += "; Max-Age=";
+    buf += std::to_string(c.max_age);
+  }
+  if (c.secure) { buf += "; Secure"; }
+  if (c.http_only) { buf += "; HttpOnly"; }
+  if (!c.same_site.empty()) {
+    buf += "; SameSite=";
+    buf += c.same_site;
+  }
+  return true;
+}
+
+// Adds a Set-Cookie field to `headers` for every cookie, in order. Invalid
+// cookies (see append_set_cookie) are skipped.
+inline void append_set_cookie_fields(Headers &headers,
+                                     const std::vector<SetCookie> &cookies) {
+  for (const auto &c : cookies) {
+    std::string value;
+    if (append_set_cookie(value, c)) {
+      headers.emplace("Set-Cookie", std::move(value));
+    }
+  }
+}
+
 inline bool write_data(Stream &strm, const char *d, size_t l) {
   size_t offset = 0;
   while (offset < l) {
@@ -4879,12 +6212,20 @@ inline std::string params_to_query_str(const Params &params) {
 
 inline void parse_query_text(const char *data, std::size_t size,
                              Params &params) {
-  std::set<std::string> cache;
-  split(data, data + size, '&', [&](const char *b, const char *e) {
-    std::string kv(b, e);
-    if (cache.find(kv) != cache.end()) { return; }
-    cache.insert(std::move(kv));
+  struct raw_pair {
+    const char *data;
+    std::size_t size;
+    std::size_t index;
+  };
 
+  // Pairs are collected first and handed to Params in one bulk insert. Each
+  // key and value is copied once into its final string and decoded there.
+  // The scratch vectors are reused across calls on the same thread.
+  thread_local std::vector<Params::value_type> items;
+  thread_local std::vector<raw_pair> raw;
+  items.clear();
+  raw.clear();
+  split(data, data + size, '&', [&](const char *b, const char *e) {
     std::string key;
     std::string val;
     divide(b, static_cast<std::size_t>(e - b), '=',
@@ -4895,9 +6236,47 @@ inline void parse_query_text(const char *data, std::size_t size,
            });
 
     if (!key.empty()) {
-      params.emplace(decode_url(key, true), decode_url(val, true));
+      decode_url_inplace(key, true);
+      decode_url_inplace(val, true);
+      raw.push_back({b, static_cast<std::size_t>(e - b), items.size()});
+      items.emplace_back(std::move(key), std::move(val));
     }
   });
+
+  // Drop repeated identical 'key=value' texts, keeping the first occurrence.
+  // Sorting by the raw text keeps this O(n log n) without a set of copies.
+  // Keys are never empty here, so an emptied key marks a duplicate.
+  if (raw.size() > 1) {
+    std::sort(raw.begin(), raw.end(), [](const raw_pair &a, const raw_pair &b) {
+      auto n = (std::min)(a.size, b.size);
+      auto r = std::memcmp(a.data, b.data, n);
+      if (r != 0) { return r < 0; }
+      if (a.size != b.size) { return a.size < b.size; }
+      return a.index < b.index;
+    });
+
+    for (std::size_t i = 1; i < raw.size(); i++) {
+      const auto &prev = raw[i - 1];
+      const auto &cur = raw[i];
+      if (prev.size == cur.size &&
+          !std::memcmp(prev.data, cur.data, cur.size)) {
+        items[cur.index].first.clear();
+      }
+    }
+
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < items.size(); i++) {
+      if (!items[i].first.empty()) {
+        if (n != i) { items[n] = std::move(items[i]); }
+        n++;
+      }
+    }
+    items.erase(items.begin() + static_cast<std::ptrdiff_t>(n), items.end());
+  }
+
+  params.insert(std::make_move_iterator(items.begin()),
+                std::make_move_iterator(items.end()));
+  items.clear();
 }
 
 inline void parse_query_text(const std::string &s, Params &params) {
@@ -4939,6 +6318,39 @@ inline void parse_disposition_params(const std::string &s, Params &params) {
   });
 }
 
+// Cookie: name1=value1; name2="value2" (RFC 6265 section 4.2.1)
+inline void parse_cookie_header(const std::string &s, Cookies &cookies) {
+  cookies.clear();
+  const auto p = s.data();
+  const auto n = s.size();
+  size_t beg = 0;
+  while (beg < n) {
+    auto semi = static_cast<const char *>(std::memchr(p + beg, ';', n - beg));
+    auto end = semi ? static_cast<size_t>(semi - p) : n;
+    auto eq = static_cast<const char *>(std::memchr(p + beg, '=', end - beg));
+    if (eq) {
+      auto pos = static_cast<size_t>(eq - p);
+      auto name = trim(p, p + pos, beg, pos);
+      auto value = trim(p, p + end, pos + 1, end);
+      if (value.first > value.second) { value.second = value.first; }
+      if (value.second - value.first >= 2 && p[value.first] == '"' &&
+          p[value.second - 1] == '"') {
+        value.first++;
+        value.second--;
+      }
+      if (name.first < name.second) {
+        CookieSlice cookie;
+        cookie.name_pos = name.first;
+        cookie.name_len = name.second - name.first;
+        cookie.value_pos = value.first;
+        cookie.value_len = value.second - value.first;
+        cookies.push_back(cookie);
+      }
+    }
+    beg = end + 1;
+  }
+}
+
 #ifdef CPPHTTPLIB_NO_EXCEPTIONS
 inline bool parse_range_header(const std::string &s, Ranges &ranges) {
 #else
@@ -5495,12 +6907,15 @@ write_multipart_ranges_data(Stream &strm, const Request &req, Response &res,
 }
 
 inline bool expect_content(const Request &req) {
-  if (req.method == "POST" || req.method == "PUT" || req.method == "PATCH" ||
-      req.method == "DELETE") {
-    return true;
+  switch (req.method_id_) {
+  case Method::Post:
+  case Method::Put:
+  case Method::Patch:
+  case Method::Delete: return true;
+  default: break;
   }
-  if (req.has_header("Content-Length") &&
-      req.get_header_value_u64("Content-Length") > 0) {
+  if (req.has_header(HeaderId::ContentLength) &&
+      req.get_header_value_u64(HeaderId::ContentLength) > 0) {
     return true;
   }
   if (is_chunked_transfer_encoding(req.headers)) { return true; }
@@ -5843,6 +7258,18 @@ inline void hosted_at(const std::string &hostname,
   }
 }
 
+inline std::string escape_html(const std::string &s) {
+  std::string out;
+  detail::escape_html(s.data(), s.size(), out);
+  return out;
+}
+
+inline std::string escape_html_attribute(const std::string &s) {
+  std::string out;
+  detail::escape_html_attribute(s.data(), s.size(), out);
+  return out;
+}
+
 inline std::string append_query_params(const std::string &path,
                                        const Params &params) {
   std::string path_with_query = path;
@@ -5888,11 +7315,20 @@ inline bool Request::has_header(const std::string &key) const {
   return detail::has_header(headers, key);
 }
 
+inline bool Request::has_header(HeaderId field) const {
+  return detail::has_header(headers, field);
+}
+
 inline std::string Request::get_header_value(const std::string &key,
                                              const char *def, size_t id) const {
   return detail::get_header_value(headers, key, def, id);
 }
 
+inline std::string Request::get_header_value(HeaderId field, const char *def,
+                                             size_t id) const {
+  return detail::get_header_value(headers, field, def, id);
+}
+
 inline size_t Request::get_header_value_count(const std::string &key) const {
   auto r = headers.equal_range(key);
   return static_cast<size_t>(std::distance(r.first, r.second));
@@ -5924,6 +7360,36 @@ inline size_t Request::get_param_value_count(const std::string &key) const {
   return static_cast<size_t>(std::distance(r.first, r.second));
 }
 
+inline bool Request::has_cookie(const std::string &name) const {
+  size_t len = 0;
+  return get_cookie_value(name, len) != nullptr;
+}
+
+inline std::string Request::get_cookie_value(const std::string &name) const {
+  size_t len = 0;
+  auto value = get_cookie_value(name, len);
+  return value ? std::string(value, len) : std::string();
+}
+
+// Returns a pointer into the Cookie header value, or nullptr if there is no
+// such cookie. The first cookie with a matching name wins.
+inline const char *Request::get_cookie_value(const std::string &name,
+                                             size_t &len) const {
+  if (cookies.empty()) { return nullptr; }
+  auto it = headers.find(HeaderId::Cookie);
+  if (it == headers.end()) { return nullptr; }
+  const auto &s = it->second;
+  for (const auto &cookie : cookies) {
+    if (cookie.name_len == name.size() &&
+        cookie.value_pos + cookie.value_len <= s.size() &&
+        !s.compare(cookie.name_pos, cookie.name_len, name)) {
+      len = cookie.value_len;
+      return s.data() + cookie.value_pos;
+    }
+  }
+  return nullptr;
+}
+
 inline bool Request::is_multipart_form_data() const {
   const auto &content_type = get_header_value("Content-Type");
   return !content_type.rfind("multipart/form-data", 0);
@@ -5950,19 +7416,58 @@ Request::get_file_values(const std::string &key) const {
 }
 
 // Response implementation
+// The Set-Cookie lines written for `cookies` are visible as Set-Cookie
+// fields, after those in `headers`
 inline bool Response::has_header(const std::string &key) const {
+  if (detail::case_ignore::equal(key, "Set-Cookie")) {
+    return has_header(HeaderId::SetCookie);
+  }
   return headers.find(key) != headers.end();
 }
 
+inline bool Response::has_header(HeaderId field) const {
+  if (field == HeaderId::SetCookie) {
+    return get_header_value_count("Set-Cookie") != 0;
+  }
+  return detail::has_header(headers, field);
+}
+
 inline std::string Response::get_header_value(const std::string &key,
                                               const char *def,
                                               size_t id) const {
+  if (detail::case_ignore::equal(key, "Set-Cookie")) {
+    return get_header_value(HeaderId::SetCookie, def, id);
+  }
   return detail::get_header_value(headers, key, def, id);
 }
 
+inline std::string Response::get_header_value(HeaderId field, const char *def,
+                                              size_t id) const {
+  if (field == HeaderId::SetCookie) {
+    auto r = headers.equal_range("Set-Cookie");
+    auto n = static_cast<size_t>(std::distance(r.first, r.second));
+    if (id < n) { return detail::get_header_value(headers, field, def, id); }
+    id -= n;
+    for (const auto &c : cookies) {
+      std::string value;
+      if (detail::append_set_cookie(value, c) && id-- == 0) { return value; }
+    }
+    return def;
+  }
+  return detail::get_header_value(headers, field, def, id);
+}
+
 inline size_t Response::get_header_value_count(const std::string &key) const {
   auto r = headers.equal_range(key);
-  return static_cast<size_t>(std::distance(r.first, r.second));
+  auto n = static_cast<size_t>(std::distance(r.first, r.second));
+  if (detail::case_ignore::equal(key, "Set-Cookie")) {
+    std::string value;
+    for (const auto &c : cookies) {
+      value.clear();
+      if (detail::append_set_cookie(value, c)) { n++; }
+    }
+  }
+  return n;
 }
 
 inline void Response::set_header(const std::string &key,
@@ -5973,6 +7478,15 @@ inline void Response::set_header(const std::string &key,
   }
 }
 
+inline SetCookie &Response::add_cookie(const std::string &name,
+                                       const std::string &value) {
+  cookies.emplace_back();
+  auto &cookie = cookies.back();
+  cookie.name = name;
+  cookie.value = value;
+  return cookie;
+}
+
 inline void Response::set_redirect(const std::string &url, int stat) {
   if (detail::fields::is_field_value(url)) {
     set_header("Location", url);
@@ -6047,6 +7561,134 @@ inline void Response::set_file_content(const std::string &path) {
   file_content_path_ = path;
 }
 
+// Template implementation
+inline Template::Template(const std::string &source,
+                          std::initializer_list<const char *> fields)
+    : source_(source), field_count_(fields.size()) {
+  const auto n = source_.size();
+  size_t literal_beg = 0;
+  auto add_literal = [&](size_t end) {
+    if (end > literal_beg) {
+      pieces_.push_back({literal_beg, end - literal_beg, std::string::npos,
+                         Escape::None});
+      literal_size_ += end - literal_beg;
+    }
+  };
+
+  // Just enough HTML tokenizing to tell text from attribute values
+  auto in_tag = false;
+  char quote = 0;
+
+  size_t i = 0;
+  while (i < n) {
+    if (source_[i] == '{' && i + 1 < n && source_[i + 1] == '{') {
+      auto raw = i + 2 < n && source_[i + 2] == '{';
+      const char *close = raw ? "}}}" : "}}";
+      auto open_len = raw ? size_t(3) : size_t(2);
+      auto end = source_.find(close, i + open_len);
+      if (end == std::string::npos) {
+#ifndef CPPHTTPLIB_NO_EXCEPTIONS
+        throw std::invalid_argument("Unterminated placeholder at offset " +
+                                    std::to_string(i) + " in template.");
+#endif
+        return;
+      }
+
+      auto r = detail::trim(source_.data(), source_.data() + end, i + open_len,
+                            end);
+      auto field = std::string::npos;
+      size_t index = 0;
+      for (auto name : fields) {
+        if (!source_.compare(r.first, r.second - r.first, name)) {
+          field = index;
+          break;
+        }
+        index++;
+      }
+      if (field == std::string::npos) {
+#ifndef CPPHTTPLIB_NO_EXCEPTIONS
+        throw std::invalid_argument(
+            "Placeholder '" + source_.substr(r.first, r.second - r.first) +
+            "' in template is not a declared field.");
+#endif
+        return;
+      }
+
+      add_literal(i);
+      pieces_.push_back({0, 0, field,
+                         raw      ? Escape::None
+                         : in_tag ? Escape::Attribute
+                                  : Escape::Html});
+      i = end + open_len;
+      literal_beg = i;
+      continue;
+    }
+
+    auto c = source_[i];
+    if (in_tag) {
+      if (quote) {
+        if (c == quote) { quote = 0; }
+      } else if (c == '"' || c == '\'') {
+        quote = c;
+      } else if (c == '>') {
+        in_tag = false;
+      }
+    } else if (c == '<' && i + 1 < n &&
+               (std::isalpha(static_cast<uint8_t>(source_[i + 1])) ||
+                source_[i + 1] == '/' || source_[i + 1] == '!')) {
+      in_tag = true;
+    }
+    i++;
+  }
+  add_literal(n);
+  valid_ = true;
+}
+
+inline bool Template::is_valid() const { return valid_; }
+
+inline std::string
+Template::render(std::initializer_list<TemplateValue> values) const {
+  std::string out;
+  render(out, values);
+  return out;
+}
+
+inline void
+Template::render(std::string &out,
+                 std::initializer_list<TemplateValue> values) const {
+  if (values.size() != field_count_) {
+#ifndef CPPHTTPLIB_NO_EXCEPTIONS
+    throw std::invalid_argument("Template expects " +
+                                std::to_string(field_count_) +
+                                " values, got " +
+                                std::to_string(values.size()) + ".");
+#endif
+    return;
+  }
+  if (!valid_) { return; }
+
+  auto size = literal_size_;
+  for (const auto &v : values) {
+    size += v.size;
+  }
+  out.reserve(out.size() + size);
+
+  for (const auto &piece : pieces_) {
+    if (piece.field == std::string::npos) {
+      out.append(source_, piece.offset, piece.length);
+      continue;
+    }
+    const auto &v = values.begin()[piece.field];
+    switch (piece.escape) {
+    case Escape::None: out.append(v.data, v.size); break;
+    case Escape::Html: detail::escape_html(v.data, v.size, out); break;
+    case Escape::Attribute:
+      detail::escape_html_attribute(v.data, v.size, out);
+      break;
+    }
+  }
+}
+
 // Result implementation
 inline bool Result::has_request_header(const std::string &key) const {
   return request_headers_.find(key) != request_headers_.end();
@@ -6425,6 +8067,7 @@ inline bool Server::set_mount_point(const std::string &mount_point,
     std::string mnt = !mount_point.empty() ? mount_point : "/";
     if (!mnt.empty() && mnt[0] == '/') {
       base_dirs_.push_back({mnt, dir, std::move(headers)});
+      mime_table_ = detail::mime_table(file_extension_and_mimetype_map_);
       return true;
     }
   }
@@ -6445,6 +8088,7 @@ inline Server &
 Server::set_file_extension_and_mimetype_mapping(const std::string &ext,
                                                 const std::string &mime) {
   file_extension_and_mimetype_map_[ext] = mime;
+  mime_table_ = detail::mime_table(file_extension_and_mimetype_map_);
   return *this;
 }
 
@@ -6563,6 +8207,18 @@ inline Server &Server::set_idle_interval(time_t sec, time_t usec) {
   return *this;
 }
 
+inline Server &Server::set_header_timeout(time_t sec, time_t usec) {
+  header_timeout_sec_ = sec;
+  header_timeout_usec_ = usec;
+  return *this;
+}
+
+inline Server &Server::set_request_timeout(time_t sec, time_t usec) {
+  request_timeout_sec_ = sec;
+  request_timeout_usec_ = usec;
+  return *this;
+}
+
 inline Server &Server::set_payload_max_length(size_t length) {
   payload_max_length_ = length;
   return *this;
@@ -6628,11 +8284,8 @@ inline bool Server::parse_request_line(const char *s, Request &req) const {
     if (count != 3) { return false; }
   }
 
-  thread_local const std::set<std::string> methods{
-      "GET",     "HEAD",    "POST",  "PUT",   "DELETE",
-      "CONNECT", "OPTIONS", "TRACE", "PATCH", "PRI"};
-
-  if (methods.find(req.method) == methods.end()) { return false; }
+  req.method_id_ = detail::method_of(req.method);
+  if (req.method_id_ == Method::Unknown) { return false; }
 
   if (req.version != "HTTP/1.1" && req.version != "HTTP/1.0") { return false; }
 
@@ -6687,7 +8340,10 @@ inline bool Server::write_response_core(Stream &strm, bool close_connection,
   if (need_apply_ranges) { apply_ranges(req, res, content_type, boundary); }
 
   // Prepare additional headers
-  if (close_connection || req.get_header_value("Connection") == "close") {
+  if (close_connection ||
+      !strcmp(detail::get_header_value(req.headers, HeaderId::Connection, "",
+                                       0),
+              "close")) {
     res.set_header("Connection", "close");
   } else {
     std::string s = "timeout=";
@@ -6698,16 +8354,17 @@ inline bool Server::write_response_core(Stream &strm, bool close_connection,
   }
 
   if ((!res.body.empty() || res.content_length_ > 0 || res.content_provider_) &&
-      !res.has_header("Content-Type")) {
+      !res.has_header(HeaderId::ContentType)) {
     res.set_header("Content-Type", "text/plain");
   }
 
   if (res.body.empty() && !res.content_length_ && !res.content_provider_ &&
-      !res.has_header("Content-Length")) {
+      !res.has_header(HeaderId::ContentLength)) {
     res.set_header("Content-Length", "0");
   }
 
-  if (req.method == "HEAD" && !res.has_header("Accept-Ranges")) {
+  if (req.method_id_ == Method::Head &&
+      !res.has_header(HeaderId::AcceptRanges)) {
     res.set_header("Accept-Ranges", "bytes");
   }
 
@@ -6717,7 +8374,14 @@ inline bool Server::write_response_core(Stream &strm, bool close_connection,
   {
     detail::BufferStream bstrm;
     if (!detail::write_response_line(bstrm, res.status)) { return false; }
-    if (!header_writer_(bstrm, res.headers)) { return false; }
+    if (res.cookies.empty()) {
+      if (!header_writer_(bstrm, res.headers)) { return false; }
+    } else {
+      // The cookies go through the header writer too, after res.headers
+      auto headers = res.headers;
+      detail::append_set_cookie_fields(headers, res.cookies);
+      if (!header_writer_(bstrm, headers)) { return false; }
+    }
 
     // Flush buffer
     auto &data = bstrm.get_buffer();
@@ -6726,7 +8390,7 @@ inline bool Server::write_response_core(Stream &strm, bool close_connection,
 
   // Body
   auto ret = true;
-  if (req.method != "HEAD") {
+  if (req.method_id_ != Method::Head) {
     if (!res.body.empty()) {
       if (!detail::write_data(strm, res.body.data(), res.body.size())) {
         ret = false;
@@ -6885,7 +8549,8 @@ Server::read_content_core(Stream &strm, Request &req, Response &res,
                      uint64_t /*len*/) { return receiver(buf, n); };
   }
 
-  if (req.method == "DELETE" && !req.has_header("Content-Length")) {
+  if (req.method_id_ == Method::Delete &&
+      !req.has_header(HeaderId::ContentLength)) {
     return true;
   }
 
@@ -6930,14 +8595,14 @@ inline bool Server::handle_file_request(const Request &req, Response &res) {
 
           res.set_content_provider(
               mm->size(),
-              detail::find_content_type(path, file_extension_and_mimetype_map_,
+              detail::find_content_type(path, mime_table_,
                                         default_file_mimetype_),
               [mm](size_t offset, size_t length, DataSink &sink) -> bool {
                 sink.write(mm->data() + offset, length);
                 return true;
               });
 
-          if (req.method != "HEAD" && file_request_handler_) {
+          if (req.method_id_ != Method::Head && file_request_handler_) {
             file_request_handler_(req, res);
           }
 
@@ -7000,6 +8665,11 @@ inline bool Server::listen_internal() {
   is_running_ = true;
   auto se = detail::scope_exit([&]() { is_running_ = false; });
 
+  if (header_timeout_sec_ > 0 || header_timeout_usec_ > 0 ||
+      request_timeout_sec_ > 0 || request_timeout_usec_ > 0) {
+    watchdog_.reset(new detail::connection_watchdog());
+  }
+
   {
     std::unique_ptr<TaskQueue> task_queue(new_task_queue());
 
@@ -7060,6 +8730,8 @@ inline bool Server::listen_internal() {
     task_queue->shutdown();
   }
 
+  watchdog_.reset();
+
   is_decommissioned = !ret;
   return ret;
 }
@@ -7071,7 +8743,7 @@ inline bool Server::routing(Request &req, Response &res, Stream &strm) {
   }
 
   // File handler
-  if ((req.method == "GET" || req.method == "HEAD") &&
+  if ((req.method_id_ == Method::Get || req.method_id_ == Method::Head) &&
       handle_file_request(req, res)) {
     return true;
   }
@@ -7090,30 +8762,22 @@ inline bool Server::routing(Request &req, Response &res, Stream &strm) {
                                                       std::move(receiver));
           });
 
-      if (req.method == "POST") {
-        if (dispatch_request_for_content_reader(
-                req, res, std::move(reader),
-                post_handlers_for_content_reader_)) {
-          return true;
-        }
-      } else if (req.method == "PUT") {
-        if (dispatch_request_for_content_reader(
-                req, res, std::move(reader),
-                put_handlers_for_content_reader_)) {
-          return true;
-        }
-      } else if (req.method == "PATCH") {
-        if (dispatch_request_for_content_reader(
-                req, res, std::move(reader),
-                patch_handlers_for_content_reader_)) {
-          return true;
-        }
-      } else if (req.method == "DELETE") {
-        if (dispatch_request_for_content_reader(
-                req, res, std::move(reader),
-                delete_handlers_for_content_reader_)) {
-          return true;
-        }
+      const HandlersForContentReader *handlers = nullptr;
+      switch (req.method_id_) {
+      case Method::Post: handlers = &post_handlers_for_content_reader_; break;
+      case Method::Put: handlers = &put_handlers_for_content_reader_; break;
+      case Method::Patch:
+        handlers = &patch_handlers_for_content_reader_;
+        break;
+      case Method::Delete:
+        handlers = &delete_handlers_for_content_reader_;
+        break;
+      default: break;
+      }
+
+      if (handlers && dispatch_request_for_content_reader(
+                          req, res, std::move(reader), *handlers)) {
+        return true;
       }
     }
 
@@ -7122,18 +8786,15 @@ inline bool Server::routing(Request &req, Response &res, Stream &strm) {
   }
 
   // Regular handler
-  if (req.method == "GET" || req.method == "HEAD") {
-    return dispatch_request(req, res, get_handlers_);
-  } else if (req.method == "POST") {
-    return dispatch_request(req, res, post_handlers_);
-  } else if (req.method == "PUT") {
-    return dispatch_request(req, res, put_handlers_);
-  } else if (req.method == "DELETE") {
-    return dispatch_request(req, res, delete_handlers_);
-  } else if (req.method == "OPTIONS") {
-    return dispatch_request(req, res, options_handlers_);
-  } else if (req.method == "PATCH") {
-    return dispatch_request(req, res, patch_handlers_);
+  switch (req.method_id_) {
+  case Method::Get:
+  case Method::Head: return dispatch_request(req, res, get_handlers_);
+  case Method::Post: return dispatch_request(req, res, post_handlers_);
+  case Method::Put: return dispatch_request(req, res, put_handlers_);
+  case Method::Delete: return dispatch_request(req, res, delete_handlers_);
+  case Method::Options: return dispatch_request(req, res, options_handlers_);
+  case Method::Patch: return dispatch_request(req, res, patch_handlers_);
+  default: break;
   }
 
   res.status = StatusCode::BadRequest_400;
@@ -7297,6 +8958,25 @@ Server::process_request(Stream &strm, const std::string &remote_addr,
                         const std::function<void(Request &)> &setup_request) {
   std::array<char, 2048> buf{};
 
+  // Absolute header and request deadlines
+  auto sock = strm.socket();
+  auto start = std::chrono::steady_clock::now();
+  auto header_timeout = std::chrono::seconds(header_timeout_sec_) +
+                        std::chrono::microseconds(header_timeout_usec_);
+  auto request_timeout = std::chrono::seconds(request_timeout_sec_) +
+                         std::chrono::microseconds(request_timeout_usec_);
+  if (watchdog_) {
+    auto timeout = header_timeout;
+    if (timeout.count() <= 0 ||
+        (request_timeout.count() > 0 && request_timeout < timeout)) {
+      timeout = request_timeout;
+    }
+    if (timeout.count() > 0) { watchdog_->arm(sock, start + timeout); }
+  }
+  auto disarm = detail::scope_exit([&]() {
+    if (watchdog_) { watchdog_->disarm(sock); }
+  });
+
   detail::stream_line_reader line_reader(strm, buf.data(), buf.size());
 
   // Connection has been closed on client
@@ -7315,6 +8995,14 @@ Server::process_request(Stream &strm, const std::string &remote_addr,
     return write_response(strm, close_connection, req, res);
   }
 
+  if (watchdog_ && header_timeout.count() > 0) {
+    if (request_timeout.count() > 0) {
+      watchdog_->arm(sock, start + request_timeout);
+    } else {
+      watchdog_->disarm(sock);
+    }
+  }
+
   // Check if the request URI doesn't exceed the limit
   if (req.target.size() > CPPHTTPLIB_REQUEST_URI_MAX_LENGTH) {
     Headers dummy;
@@ -7323,12 +9011,12 @@ Server::process_request(Stream &strm, const std::string &remote_addr,
     return write_response(strm, close_connection, req, res);
   }
 
-  if (req.get_header_value("Connection") == "close") {
-    connection_closed = true;
-  }
+  const auto connection =
+      detail::get_header_value(req.headers, HeaderId::Connection, "", 0);
 
-  if (req.version == "HTTP/1.0" &&
-      req.get_header_value("Connection") != "Keep-Alive") {
+  if (!strcmp(connection, "close")) { connection_closed = true; }
+
+  if (req.version == "HTTP/1.0" && strcmp(connection, "Keep-Alive")) {
     connection_closed = true;
   }
 
@@ -7342,8 +9030,13 @@ Server::process_request(Stream &strm, const std::string &remote_addr,
   req.set_header("LOCAL_ADDR", req.local_addr);
   req.set_header("LOCAL_PORT", std::to_string(req.local_port));
 
-  if (req.has_header("Range")) {
-    const auto &range_header_value = req.get_header_value("Range");
+  auto cookie_header = req.headers.find(HeaderId::Cookie);
+  if (cookie_header != req.headers.end()) {
+    detail::parse_cookie_header(cookie_header->second, req.cookies);
+  }
+
+  if (req.has_header(HeaderId::Range)) {
+    const auto &range_header_value = req.get_header_value(HeaderId::Range);
     if (!detail::parse_range_header(range_header_value, req.ranges)) {
       res.status = StatusCode::RangeNotSatisfiable_416;
       return write_response(strm, close_connection, req, res);
@@ -7352,7 +9045,8 @@ Server::process_request(Stream &strm, const std::string &remote_addr,
 
   if (setup_request) { setup_request(req); }
 
-  if (req.get_header_value("Expect") == "100-continue") {
+  if (!strcmp(detail::get_header_value(req.headers, HeaderId::Expect, "", 0),
+              "100-continue")) {
     int status = StatusCode::Continue_100;
     if (expect_100_continue_handler_) {
       status = expect_100_continue_handler_(req, res);
@@ -7370,7 +9064,6 @@ Server::process_request(Stream &strm, const std::string &remote_addr,
   }
 
   // Setup `is_connection_closed` method
-  auto sock = strm.socket();
   req.is_connection_closed = [sock]() {
     return !detail::is_socket_alive(sock);
   };
@@ -7431,8 +9124,8 @@ Server::process_request(Stream &strm, const std::string &remote_addr,
 
       auto content_type = res.file_content_content_type_;
       if (content_type.empty()) {
-        content_type = detail::find_content_type(
-            path, file_extension_and_mimetype_map_, default_file_mimetype_);
+        content_type = detail::find_content_type(path, mime_table_,
+                                                 default_file_mimetype_);
       }
 
       res.set_content_provider(
@@ -7485,6 +9178,341 @@ inline bool Server::process_and_close_socket(socket_t sock) {
   return ret;
 }
 
+// ConcurrencyLimiter implementation
+inline ConcurrencyLimiter::ConcurrencyLimiter(
+    size_t max_concurrent, size_t max_queue, std::chrono::milliseconds max_wait)
+    : max_concurrent_(max_concurrent ? max_concurrent : 1),
+      max_queue_(max_queue), max_wait_(max_wait) {}
+
+inline Server::Handler ConcurrencyLimiter::wrap(Server::Handler handler) {
+  return [this, handler](const Request &req, Response &res) {
+    if (!acquire()) {
+      res.status = StatusCode::ServiceUnavailable_503;
+      return;
+    }
+
+    auto deferred = false;
+    auto se = detail::scope_exit([&] {
+      if (!deferred) { release(); }
+    });
+
+    handler(req, res);
+
+    if (res.content_provider_) {
+      // Keep the slot until the provider has finished streaming
+      auto releaser = std::move(res.content_provider_resource_releaser_);
+      res.content_provider_resource_releaser_ = [this, releaser](bool success) {
+        if (releaser) { releaser(success); }
+        release();
+      };
+      deferred = true;
+    }
+  };
+}
+
+inline bool ConcurrencyLimiter::acquire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (active_ < max_concurrent_) {
+    active_++;
+    return true;
+  }
+  if (waiting_ >= max_queue_) { return false; }
+
+  waiting_++;
+  auto has_slot = [&] { return active_ < max_concurrent_; };
+  auto ok = true;
+  if (max_wait_ > std::chrono::milliseconds::zero()) {
+    ok = cond_.wait_for(lock, max_wait_, has_slot);
+  } else {
+    cond_.wait(lock, has_slot);
+  }
+  waiting_--;
+
+  if (ok) { active_++; }
+  return ok;
+}
+
+inline void ConcurrencyLimiter::release() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    active_--;
+  }
+  cond_.notify_one();
+}
+
+// RequestCoalescer implementation
+inline RequestCoalescer::RequestCoalescer(Key key) : key_(std::move(key)) {}
+
+inline Server::Handler RequestCoalescer::wrap(Server::Handler handler) {
+  return [this, handler](const Request &req, Response &res) {
+    auto key =
+        key_ ? key_(req) : req.method + ' ' + req.target + '\n' + req.body;
+
+    std::shared_ptr<Flight> flight;
+    auto leader = false;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      auto &slot = flights_[key];
+      if (!slot) {
+        slot = std::make_shared<Flight>();
+        leader = true;
+      }
+      flight = slot;
+    }
+
+    if (leader) {
+      auto se = detail::scope_exit([&] {
+        {
+          std::lock_guard<std::mutex> guard(mutex_);
+          flights_.erase(key);
+          flight->done = true;
+        }
+        cond_.notify_all();
+      });
+
+      handler(req, res);
+
+      if (!res.content_provider_) {
+        flight->shared = true;
+        flight->status = res.status;
+        flight->reason = res.reason;
+        flight->headers = res.headers;
+        flight->cookies = res.cookies;
+        flight->body = res.body;
+        flight->location = res.location;
+      }
+      return;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [&] { return flight->done; });
+    }
+
+    if (!flight->shared) {
+      handler(req, res);
+      return;
+    }
+    res.status = flight->status;
+    res.reason = flight->reason;
+    res.headers = flight->headers;
+    res.cookies = flight->cookies;
+    res.body = flight->body;
+    res.location = flight->location;
+  };
+}
+
+// ResponseCache implementation
+inline ResponseCache::ResponseCache(size_t max_bytes,
+                                    std::chrono::milliseconds ttl, Key key)
+    : shard_budget_(max_bytes / shard_count), ttl_(ttl), key_(std::move(key)) {
+}
+
+inline Server::Handler ResponseCache::wrap(Server::Handler handler) {
+  return [this, handler](const Request &req, Response &res) {
+    if (req.method_id_ != Method::Get && req.method_id_ != Method::Head) {
+      handler(req, res);
+      return;
+    }
+
+    auto key = key_ ? key_(req) : default_key(req);
+    auto request_cc = req.get_header_value(HeaderId::CacheControl);
+    std::string arg;
+    auto bypass = find_directive(request_cc, "no-cache", arg) ||
+                  find_directive(request_cc, "no-store", arg);
+
+    auto entry = bypass ? nullptr : find(key);
+    auto hit = entry != nullptr;
+    if (!hit) {
+      handler(req, res);
+      entry = store(std::move(key), res);
+      if (!entry) { return; }
+    }
+
+    if (etag_matches(req.get_header_value(HeaderId::IfNoneMatch),
+                     entry->etag)) {
+      res.status = StatusCode::NotModified_304;
+      res.headers.clear();
+      res.cookies.clear();
+      res.body.clear();
+      res.set_header("ETag", entry->etag);
+      res.set_header("Cache-Control", entry->cache_control);
+      return;
+    }
+
+    // The status stays unset so range requests still become 206
+    res.headers = entry->headers;
+    if (hit) { res.body = entry->body; }
+  };
+}
+
+inline void ResponseCache::clear() {
+  for (auto &shard : shards_) {
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    shard.lru.clear();
+    shard.index.clear();
+    shard.bytes = 0;
+  }
+}
+
+inline ResponseCache::Shard &ResponseCache::shard_for(const std::string &key) {
+  return shards_[std::hash<std::string>()(key) % shard_count];
+}
+
+inline ResponseCache::EntryPtr ResponseCache::find(const std::string &key) {
+  auto &shard = shard_for(key);
+  std::lock_guard<std::mutex> guard(shard.mutex);
+  auto it = shard.index.find(key);
+  if (it == shard.index.end()) { return nullptr; }
+
+  auto pos = it->second;
+  if (Clock::now() >= (*pos)->expires) {
+    remove(shard, pos);
+    return nullptr;
+  }
+  shard.lru.splice(shard.lru.begin(), shard.lru, pos);
+  return *pos;
+}
+
+inline ResponseCache::EntryPtr ResponseCache::store(std::string key,
+                                                    const Response &res) {
+  if ((res.status != -1 && res.status != StatusCode::OK_200) ||
+      res.content_provider_ || !res.file_content_path_.empty() ||
+      res.has_header(HeaderId::SetCookie)) {
+    return nullptr;
+  }
+
+  auto ttl = ttl_;
+  auto cache_control = res.get_header_value(HeaderId::CacheControl);
+  std::string arg;
+  if (find_directive(cache_control, "no-store", arg) ||
+      find_directive(cache_control, "private", arg)) {
+    return nullptr;
+  }
+  if (find_directive(cache_control, "max-age", arg)) {
+    auto max_age = std::chrono::seconds(std::atoi(arg.c_str()));
+    if (max_age < ttl) { ttl = max_age; }
+  }
+  if (ttl <= std::chrono::milliseconds::zero()) { return nullptr; }
+
+  auto entry = std::make_shared<Entry>();
+  entry->key = std::move(key);
+  entry->headers = res.headers;
+  entry->body = res.body;
+  entry->etag = res.get_header_value(HeaderId::ETag);
+  if (entry->etag.empty()) {
+    entry->etag = make_etag(res.body);
+    entry->headers.emplace("ETag", entry->etag);
+  }
+  if (cache_control.empty()) {
+    cache_control = "no-cache";
+    entry->headers.emplace("Cache-Control", cache_control);
+  }
+  entry->cache_control = std::move(cache_control);
+  entry->expires = Clock::now() + ttl;
+
+  // The key is held twice: in the entry and in the index
+  entry->bytes = sizeof(Entry) + 2 * entry->key.size() + entry->body.size();
+  for (const auto &h : entry->headers) {
+    entry->bytes += h.first.size() + h.second.size();
+  }
+  if (entry->bytes > shard_budget_) { return entry; }
+
+  auto &shard = shard_for(entry->key);
+  std::lock_guard<std::mutex> guard(shard.mutex);
+  auto it = shard.index.find(entry->key);
+  if (it != shard.index.end()) { remove(shard, it->second); }
+
+  shard.lru.push_front(entry);
+  shard.index.emplace(entry->key, shard.lru.begin());
+  shard.bytes += entry->bytes;
+  while (shard.bytes > shard_budget_) {
+    remove(shard, std::prev(shard.lru.end()));
+  }
+  return entry;
+}
+
+inline void ResponseCache::remove(Shard &shard,
+                                  std::list<EntryPtr>::iterator it) {
+  shard.bytes -= (*it)->bytes;
+  shard.index.erase((*it)->key);
+  shard.lru.erase(it);
+}
+
+inline std::string ResponseCache::default_key(const Request &req) {
+  auto append = [](std::string &key, const std::string &part) {
+    key += std::to_string(part.size());
+    key += ':';
+    key += part;
+  };
+
+  // Params are kept sorted, so reordered query strings share an entry
+  std::string key;
+  append(key, req.path);
+  for (const auto &p : req.params) {
+    append(key, p.first);
+    append(key, p.second);
+  }
+  return key;
+}
+
+inline std::string ResponseCache::make_etag(const std::string &body) {
+  // FNV-1a over the body
+  uint64_t h = 14695981039346656037ull;
+  for (auto c : body) {
+    h ^= static_cast<unsigned char>(c);
+    h *= 1099511628211ull;
+  }
+
+  static const auto charset = "0123456789abcdef";
+  std::string etag(18, '"');
+  for (size_t i = 16; i > 0; i--, h >>= 4) {
+    etag[i] = charset[h & 15];
+  }
+  return etag;
+}
+
+inline bool ResponseCache::etag_matches(const std::string &if_none_match,
+                                        const std::string &etag) {
+  // Weak comparison: a W/ prefix on either side is ignored
+  auto strip = [](const char *b, const char *e) {
+    if (e - b > 2 && b[0] == 'W' && b[1] == '/') { b += 2; }
+    return std::make_pair(b, e);
+  };
+  auto target = strip(etag.data(), etag.data() + etag.size());
+
+  auto found = false;
+  detail::split(if_none_match.data(),
+                if_none_match.data() + if_none_match.size(), ',',
+                [&](const char *b, const char *e) {
+                  auto tag = strip(b, e);
+                  if ((e - b == 1 && *b == '*') ||
+                      (tag.second - tag.first ==
+                           target.second - target.first &&
+                       std::equal(tag.first, tag.second, target.first))) {
+                    found = true;
+                  }
+                });
+  return found;
+}
+
+inline bool ResponseCache::find_directive(const std::string &cache_control,
+                                          const char *name, std::string &arg) {
+  auto found = false;
+  detail::split(cache_control.data(),
+                cache_control.data() + cache_control.size(), ',',
+                [&](const char *b, const char *e) {
+                  auto eq = std::find(b, e, '=');
+                  if (found ||
+                      !detail::case_ignore::equal(std::string(b, eq), name)) {
+                    return;
+                  }
+                  found = true;
+                  arg.assign(eq == e ? e : eq + 1, e);
+                });
+  return found;
+}
+
 // HTTP client implementation
 inline ClientImpl::ClientImpl(const std::string &host)
     : ClientImpl(host, 80, std::string(), std::string()) {}
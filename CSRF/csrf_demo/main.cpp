@@ -1,48 +1,54 @@
 #include "httplib.h"
-#include <unordered_map>
-#include <random>
+#include "session_log.h"
+#include "session_store.h"
+#include "token_generator.h"
+#include <cstdlib>
+#include <memory>
 #include <sstream>
 #include <ctime>
 
 using namespace httplib;
 
-// Session store
-struct Session {
-    std::string username;
-    std::string email;
-    std::string csrf_token;
-};
+// Session store (shared by all worker threads); idle sessions expire after 30 minutes
+ShardedSessionStore<> sessions;
 
-std::unordered_map<std::string, Session> sessions;
+// Profile page, parsed once at startup
+const Template profile_page(R"(
+            <h2>Welcome, {{username}}</h2>
+            <p>Current email: {{email}}</p>
+            <form method="POST" action="/change_email">
+                New Email: <input name="email" type="text">
+                <input type="hidden" name="csrf_token" value="{{csrf_token}}">
+                <input type="submit" value="Update Email">
+            </form>
+            <br><a href="/logout">Logout</a>
+        )", {"username", "email", "csrf_token"});
 
 // Utility: Generate random strings
 std::string generate_token(int length = 32) {
-    static const char charset[] =
-        "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, sizeof(charset) - 2);
-    std::string token;
-    for (int i = 0; i < length; ++i)
-        token += charset[dis(gen)];
-    return token;
+    return TokenGenerator::generate(length);
 }
 
 // Utility: Get session ID from cookies
 std::string get_session_id(const Request& req) {
-    auto it = req.headers.find("Cookie");
-    if (it == req.headers.end()) return "";
-    std::string cookie = it->second;
-    std::string prefix = "SESSION_ID=";
-    size_t pos = cookie.find(prefix);
-    if (pos == std::string::npos) return "";
-    size_t end = cookie.find(";", pos);
-    return cookie.substr(pos + prefix.size(), end - pos - prefix.size());
+    return req.get_cookie_value("SESSION_ID");
 }
 
 int main() {
     Server svr;
 
+    // Optional persistence: CSRF_SESSION_LOG=/path/to/sessions.log keeps
+    // sessions across restarts
+    std::unique_ptr<SessionLog> session_log;
+    if (const char* path = std::getenv("CSRF_SESSION_LOG")) {
+        session_log.reset(new SessionLog(path));
+        sessions.restore(session_log->recover());
+        sessions.attach_journal(session_log.get());
+        sessions.compact_journal();
+        std::cout << "Restored " << sessions.size() << " sessions from " << path << "\n";
+    }
+    sessions.start_sweeper();
+
     // Login Page
     svr.Get("/", [](const Request& req, Response& res) {
         std::string html = R"(
@@ -65,9 +71,9 @@ int main() {
         if (username == "admin" && password == "admin") {
             std::string session_id = generate_token();
             std::string csrf_token = generate_token(16);
-            sessions[session_id] = {username, "admin@example.com", csrf_token};
+            sessions.put(session_id, {username, "admin@example.com", csrf_token});
 
-            res.set_header("Set-Cookie", "SESSION_ID=" + session_id + "; HttpOnly");
+            res.add_cookie("SESSION_ID", session_id).http_only = true;
             res.set_redirect("/profile");
         } else {
             res.set_content("Invalid login. <a href='/'>Try again</a>", "text/html");
@@ -77,74 +83,76 @@ int main() {
     // Profile Page
     svr.Get("/profile", [](const Request& req, Response& res) {
         std::string session_id = get_session_id(req);
-        if (sessions.find(session_id) == sessions.end()) {
+        std::string html;
+        bool found = sessions.read(session_id, [&](const Session& session) {
+            html = profile_page.render({session.username, session.email, session.csrf_token});
+        });
+        if (!found) {
             res.set_redirect("/");
             return;
         }
 
-        Session& session = sessions[session_id];
-        std::string html = R"(
-            <h2>Welcome, )" + session.username + R"(</h2>
-            <p>Current email: )" + session.email + R"(</p>
-            <form method="POST" action="/change_email">
-                New Email: <input name="email" type="text">
-                <input type="hidden" name="csrf_token" value=")" + session.csrf_token + R"(">
-                <input type="submit" value="Update Email">
-            </form>
-            <br><a href="/logout">Logout</a>
-        )";
-
         res.set_content(html, "text/html");
     });
 
     // Email change with CSRF validation
     svr.Post("/change_email2", [](const Request& req, Response& res) {
         std::string session_id = get_session_id(req);
-        if (sessions.find(session_id) == sessions.end()) {
+        std::string new_email = req.get_param_value("email");
+        std::string submitted_token = req.get_param_value("csrf_token");
+
+        bool token_ok = false;
+        bool found = sessions.update(session_id, [&](Session& session) {
+            token_ok = submitted_token == session.csrf_token;
+            if (token_ok) session.email = new_email;
+        });
+        if (!found) {
             res.set_redirect("/");
             return;
         }
 
-        Session& session = sessions[session_id];
-        std::string new_email = req.get_param_value("email");
-        std::string submitted_token = req.get_param_value("csrf_token");
-
-        if (submitted_token != session.csrf_token) {
+        if (!token_ok) {
             res.status = 403;
             res.set_content("CSRF token invalid", "text/plain");
             return;
         }
 
-        session.email = new_email;
-        res.set_content("Email updated to: " + session.email + "<br><a href='/profile'>Back</a>", "text/html");
+        res.set_content("Email updated to: " + new_email + "<br><a href='/profile'>Back</a>", "text/html");
     });
 
 
     // Email change with CSRF validation
     svr.Post("/change_email", [](const Request& req, Response& res) {
         std::string session_id = get_session_id(req);
-        if (sessions.find(session_id) == sessions.end()) {
-            res.set_redirect("/");
-            return;
-        }
-
-        Session& session = sessions[session_id];
         std::string new_email = req.get_param_value("email");
         
        
 
-        session.email = new_email;
-        res.set_content("Email updated to: " + session.email + "<br><a href='/profile'>Back</a>", "text/html");
+        bool found = sessions.update(session_id, [&](Session& session) {
+            session.email = new_email;
+        });
+        if (!found) {
+            res.set_redirect("/");
+            return;
+        }
+
+        res.set_content("Email updated to: " + new_email + "<br><a href='/profile'>Back</a>", "text/html");
     });
 
     // Logout
     svr.Get("/logout", [](const Request& req, Response& res) {
         std::string session_id = get_session_id(req);
         sessions.erase(session_id);
-        res.set_header("Set-Cookie", "SESSION_ID=deleted; Max-Age=0");
+        res.add_cookie("SESSION_ID", "deleted").max_age = 0;
         res.set_redirect("/");
     });
 
     std::cout << "Server running at http://localhost:8080\n";
     svr.listen("0.0.0.0", 8080);
+
+    // listen() returns once the workers are gone (or the bind failed). The
+    // global store outlives session_log, so stop its sweeper, which flushes
+    // and compacts the journal, and detach the journal before it is freed.
+    sessions.stop_sweeper();
+    sessions.attach_journal(nullptr);
 }
@@ -0,0 +1,329 @@
+#ifndef SESSION_LOG_H
+#define SESSION_LOG_H
+
+#include "session_store.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Append-only session journal in a memory-mapped file.
+//
+// File layout: a 16-byte header ("CSRFSLG2" + reserved), then records of
+//   u32 body length | u32 CRC-32 of body | body
+// where the body is a type byte, the u64 last-access time (ms since the Unix
+// epoch), four u32 lengths and the id, username, email and token bytes. The
+// unused tail of the file is zero.
+//
+// Appends are plain memcpy into the mapping, so a crashed process loses
+// nothing that was appended. On open the log is scanned up to the first
+// record that is zero, truncated or fails its checksum; that torn tail is
+// wiped and later appends continue from there. compact() writes the snapshot
+// to a new file without holding the log lock, then copies over the records
+// appended since the snapshot and renames the file over the old one.
+class SessionLog : public SessionJournal {
+public:
+    explicit SessionLog(std::string path) : path_(std::move(path)) {
+        fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+        if (fd_ < 0) throw std::runtime_error("cannot open session log " + path_);
+
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) {
+            ::close(fd_);
+            throw std::runtime_error("cannot stat session log " + path_);
+        }
+        size_t size = static_cast<size_t>(st.st_size);
+        bool fresh = size < header_size;
+        if (fresh) {
+            size = initial_size;
+            if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+                ::close(fd_);
+                throw std::runtime_error("cannot size session log " + path_);
+            }
+        }
+        if (!map(size)) {
+            ::close(fd_);
+            throw std::runtime_error("cannot map session log " + path_);
+        }
+        if (fresh) {
+            std::memcpy(map_, file_magic, header_size);
+        } else if (std::memcmp(map_, file_magic, header_size) != 0) {
+            ::munmap(map_, mapped_);
+            ::close(fd_);
+            throw std::runtime_error("not a session log: " + path_);
+        }
+        scan();
+    }
+
+    ~SessionLog() override {
+        if (map_) {
+            ::msync(map_, mapped_, MS_SYNC);
+            ::munmap(map_, mapped_);
+        }
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    SessionLog(const SessionLog&) = delete;
+    SessionLog& operator=(const SessionLog&) = delete;
+
+    // Records found when the log was opened, oldest first
+    std::vector<SessionRecord> recover() { return std::move(recovered_); }
+
+    void record_put(const std::string& id, const Session& session,
+                    int64_t last_access_ms) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        append(SessionRecord::Put, id, session, last_access_ms);
+    }
+
+    void record_touch(const std::string& id, int64_t last_access_ms) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        append(SessionRecord::Touch, id, Session(), last_access_ms);
+    }
+
+    void record_erase(const std::string& id) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        append(SessionRecord::Erase, id, Session(), 0);
+    }
+
+    bool compact(const std::vector<SessionRecord>& live, size_t snapshot_end) override {
+        size_t needed = header_size;
+        for (const SessionRecord& r : live) needed += record_size(r.id, r.session);
+
+        // Write and sync the snapshot while appends continue to the old file
+        std::string tmp_path = path_ + ".tmp";
+        int fd = ::open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (fd < 0) return false;
+        size_t size = grow_size(initial_size, 2 * needed);
+        char* out = map_file(fd, size);
+        auto abandon = [&] {
+            if (out) ::munmap(out, size);
+            ::close(fd);
+            ::unlink(tmp_path.c_str());
+            return false;
+        };
+        if (!out) return abandon();
+
+        std::memcpy(out, file_magic, header_size);
+        size_t tail = header_size;
+        for (const SessionRecord& r : live) {
+            tail += encode(out + tail, SessionRecord::Put, r.id, r.session, r.last_access_ms);
+        }
+        if (::msync(out, size, MS_SYNC) != 0) return abandon();
+
+        // Carry over what was appended meanwhile, then switch files
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (failed_ || snapshot_end < header_size || snapshot_end > tail_) return abandon();
+        size_t carried = tail_ - snapshot_end;
+        if (tail + carried > size) {
+            size_t grown = grow_size(size, tail + carried);
+            ::munmap(out, size);
+            out = map_file(fd, grown);
+            size = grown;
+            if (!out) return abandon();
+        }
+        std::memcpy(out + tail, map_ + snapshot_end, carried);
+        tail += carried;
+
+        if (::msync(out, size, MS_SYNC) != 0 ||
+            ::rename(tmp_path.c_str(), path_.c_str()) != 0) {
+            return abandon();
+        }
+        sync_directory();
+
+        ::munmap(map_, mapped_);
+        ::close(fd_);
+        fd_ = fd;
+        map_ = out;
+        mapped_ = size;
+        tail_ = tail;
+        return true;
+    }
+
+    size_t size_bytes() const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return tail_;
+    }
+
+    // Schedule dirty pages for write-back (protects against power loss,
+    // not just process crashes)
+    void flush() override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (map_) ::msync(map_, mapped_, MS_ASYNC);
+    }
+
+private:
+    static constexpr char file_magic[] = "CSRFSLG2\0\0\0\0\0\0\0";
+    static constexpr size_t header_size = 16;
+    static constexpr size_t record_header_size = 8;
+    static constexpr size_t body_fixed_size = 1 + 8 + 4 * 4;
+    static constexpr size_t initial_size = 1 << 20;
+
+    static uint32_t crc32(const char* data, size_t n) {
+        static const auto table = [] {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[i] = c;
+            }
+            return t;
+        }();
+        uint32_t c = 0xFFFFFFFFu;
+        for (size_t i = 0; i < n; ++i) {
+            c = table[(c ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (c >> 8);
+        }
+        return c ^ 0xFFFFFFFFu;
+    }
+
+    static size_t record_size(const std::string& id, const Session& s) {
+        return record_header_size + body_fixed_size + id.size() + s.username.size() +
+               s.email.size() + s.csrf_token.size();
+    }
+
+    static size_t grow_size(size_t current, size_t needed) {
+        while (current < needed) current *= 2;
+        return current;
+    }
+
+    static void put_u32(char* p, uint32_t v) { std::memcpy(p, &v, 4); }
+    static uint32_t get_u32(const char* p) {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+    static void put_i64(char* p, int64_t v) { std::memcpy(p, &v, 8); }
+    static int64_t get_i64(const char* p) {
+        int64_t v;
+        std::memcpy(&v, p, 8);
+        return v;
+    }
+
+    // Write one record at `out`; returns its size
+    static size_t encode(char* out, uint8_t type, const std::string& id, const Session& s,
+                         int64_t last_access_ms) {
+        const std::string* fields[] = {&id, &s.username, &s.email, &s.csrf_token};
+        char* body = out + record_header_size;
+        char* p = body;
+        *p++ = static_cast<char>(type);
+        put_i64(p, last_access_ms);
+        p += 8;
+        for (const std::string* f : fields) {
+            put_u32(p, static_cast<uint32_t>(f->size()));
+            p += 4;
+        }
+        for (const std::string* f : fields) {
+            std::memcpy(p, f->data(), f->size());
+            p += f->size();
+        }
+        size_t body_len = static_cast<size_t>(p - body);
+        put_u32(out + 4, crc32(body, body_len));
+        put_u32(out, static_cast<uint32_t>(body_len));
+        return record_header_size + body_len;
+    }
+
+    // Size `fd` to `size` bytes and map it; nullptr on failure
+    static char* map_file(int fd, size_t size) {
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) return nullptr;
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        return p == MAP_FAILED ? nullptr : static_cast<char*>(p);
+    }
+
+    bool map(size_t size) {
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) return false;
+        map_ = static_cast<char*>(p);
+        mapped_ = size;
+        return true;
+    }
+
+    void append(uint8_t type, const std::string& id, const Session& s, int64_t last_access_ms) {
+        if (failed_) return;
+        size_t needed = tail_ + record_size(id, s);
+        if (needed > mapped_) {
+            size_t size = grow_size(mapped_, needed);
+            ::munmap(map_, mapped_);
+            map_ = nullptr;
+            if (::ftruncate(fd_, static_cast<off_t>(size)) != 0 || !map(size)) {
+                // Keep serving from memory; persistence stops until restart
+                failed_ = true;
+                std::cerr << "session log " << path_ << ": cannot grow, persistence disabled\n";
+                return;
+            }
+        }
+        tail_ += encode(map_ + tail_, type, id, s, last_access_ms);
+    }
+
+    void scan() {
+        size_t pos = header_size;
+        while (pos + record_header_size <= mapped_) {
+            size_t body_len = get_u32(map_ + pos);
+            const char* body = map_ + pos + record_header_size;
+            if (body_len < body_fixed_size ||
+                body_len > mapped_ - pos - record_header_size ||
+                get_u32(map_ + pos + 4) != crc32(body, body_len)) {
+                break;
+            }
+
+            uint8_t type = static_cast<uint8_t>(body[0]);
+            if (type < SessionRecord::Put || type > SessionRecord::Touch) break;
+
+            uint32_t lens[4];
+            size_t total = 0;
+            for (int i = 0; i < 4; ++i) {
+                lens[i] = get_u32(body + 1 + 8 + 4 * i);
+                total += lens[i];
+            }
+            if (total != body_len - body_fixed_size) break;
+
+            SessionRecord r;
+            r.type = static_cast<SessionRecord::Type>(type);
+            r.last_access_ms = get_i64(body + 1);
+            std::string* fields[] = {&r.id, &r.session.username, &r.session.email,
+                                     &r.session.csrf_token};
+            const char* p = body + body_fixed_size;
+            for (int i = 0; i < 4; ++i) {
+                fields[i]->assign(p, lens[i]);
+                p += lens[i];
+            }
+            recovered_.push_back(std::move(r));
+            pos += record_header_size + body_len;
+        }
+        tail_ = pos;
+
+        // Wipe a torn record so it cannot be mistaken for data later
+        if (tail_ + record_header_size <= mapped_ && get_u32(map_ + tail_) != 0) {
+            std::memset(map_ + tail_, 0, mapped_ - tail_);
+        }
+    }
+
+    void sync_directory() {
+        size_t slash = path_.rfind('/');
+        std::string dir = slash == std::string::npos ? "." : path_.substr(0, slash + 1);
+        int dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dfd >= 0) {
+            ::fsync(dfd);
+            ::close(dfd);
+        }
+    }
+
+    std::string path_;
+    int fd_ = -1;
+    char* map_ = nullptr;
+    size_t mapped_ = 0;
+    size_t tail_ = 0;
+    bool failed_ = false;
+    mutable std::mutex mutex_;
+    std::vector<SessionRecord> recovered_;
+};
+
+#endif // SESSION_LOG_H
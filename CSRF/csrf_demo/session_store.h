@@ -0,0 +1,444 @@
+#ifndef SESSION_STORE_H
+#define SESSION_STORE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Session data
+struct Session {
+    std::string username;
+    std::string email;
+    std::string csrf_token;
+};
+
+// A session change, as written to and replayed from a journal. Access times
+// are wall-clock milliseconds since the Unix epoch so that they still mean
+// something after a restart.
+struct SessionRecord {
+    enum Type : uint8_t {
+        Put = 1,    // session created or changed
+        Erase = 2,  // session removed
+        Touch = 3,  // session read; only last_access_ms is set
+    };
+
+    Type type = Put;
+    std::string id;
+    Session session;
+    int64_t last_access_ms = 0;
+};
+
+// Persistence hook for the session store. Puts and erases are reported while
+// the session's shard is locked exclusively, so they arrive in order for each
+// session. Touches are reported under a shared lock and may be reordered
+// among themselves; replay keeps the latest time.
+class SessionJournal {
+public:
+    virtual ~SessionJournal() = default;
+    virtual void record_put(const std::string& id, const Session& session,
+                            int64_t last_access_ms) = 0;
+    virtual void record_touch(const std::string& id, int64_t last_access_ms) = 0;
+    virtual void record_erase(const std::string& id) = 0;
+    // Replace the journal contents with `live`, a snapshot of the store taken
+    // when size_bytes() was `snapshot_end`, followed by every record appended
+    // since then. Calls must not overlap.
+    virtual bool compact(const std::vector<SessionRecord>& live, size_t snapshot_end) = 0;
+    virtual size_t size_bytes() const = 0;
+    virtual void flush() = 0;
+};
+
+// Expiry settings for the session store
+struct SessionStoreOptions {
+    std::chrono::seconds ttl{30 * 60};          // idle time before a session expires
+    size_t max_sessions = 100000;               // hard cap, enforced per shard
+    std::chrono::milliseconds sweep_interval{1000};
+    size_t sweep_batch = 64;                    // buckets visited per shard per sweep
+    size_t compact_min_bytes = 1 << 20;         // journal size before compaction is considered
+};
+
+// Session store shared by all server worker threads.
+// Sessions are spread over N shards by the hash of their id, each with its own
+// reader/writer lock, so concurrent requests for different sessions rarely
+// contend and readers of the same shard never block each other.
+//
+// Idle sessions expire after `ttl`. A background sweeper walks each shard with
+// a clock hand, a few buckets at a time, so a sweep only ever holds one shard
+// lock briefly. When a shard is full, `put` evicts using the same hand
+// (CLOCK approximation of LRU: recently used sessions get a second chance).
+//
+// With a journal attached, every change is also appended to it, and the
+// sweeper flushes it and compacts it once it is mostly dead records. Reads are
+// journaled as touches at most once per ttl / 8 per session, so that restore()
+// can tell which sessions expired while the process was down.
+template <size_t ShardCount = 16>
+class ShardedSessionStore {
+public:
+    explicit ShardedSessionStore(SessionStoreOptions options = SessionStoreOptions())
+        : options_(options),
+          max_per_shard_(options.max_sessions / ShardCount > 0
+                             ? options.max_sessions / ShardCount
+                             : 1) {}
+
+    ~ShardedSessionStore() { stop_sweeper(); }
+
+    ShardedSessionStore(const ShardedSessionStore&) = delete;
+    ShardedSessionStore& operator=(const ShardedSessionStore&) = delete;
+
+    // Add or replace a session
+    void put(const std::string& id, Session session) {
+        Shard& shard = shard_for(id);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.sessions.find(id);
+        if (it != shard.sessions.end()) {
+            shard.bytes -= footprint(it->first, it->second.session);
+            it->second.session = std::move(session);
+            shard.bytes += footprint(it->first, it->second.session);
+            it->second.touch(now_ms());
+        } else {
+            while (shard.sessions.size() >= max_per_shard_) evict_one(shard);
+            it = shard.sessions.emplace(id, Entry(std::move(session), now_ms())).first;
+            shard.bytes += footprint(it->first, it->second.session);
+        }
+        journal_put(it);
+    }
+
+    // Remove a session; returns false if it did not exist
+    bool erase(const std::string& id) {
+        Shard& shard = shard_for(id);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.sessions.find(id);
+        if (it == shard.sessions.end()) return false;
+        erase_entry(shard, it);
+        return true;
+    }
+
+    // Run `fn` on the session under a shared lock (single lookup).
+    // Returns false if the session does not exist or has expired.
+    template <typename Fn>
+    bool read(const std::string& id, Fn fn) const {
+        const Shard& shard = shard_for(id);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.sessions.find(id);
+        if (it == shard.sessions.end()) return false;
+        int64_t now = now_ms();
+        if (expired(it->second, now)) return false;
+        it->second.touch(now);
+        if (journal_ && now - it->second.journaled_ms.load(std::memory_order_relaxed) >=
+                            touch_interval_ms()) {
+            it->second.journaled_ms.store(now, std::memory_order_relaxed);
+            journal_->record_touch(it->first, wall_ms());
+        }
+        fn(it->second.session);
+        return true;
+    }
+
+    // Run `fn` on the session under an exclusive lock (single lookup).
+    // Returns false if the session does not exist or has expired.
+    template <typename Fn>
+    bool update(const std::string& id, Fn fn) {
+        Shard& shard = shard_for(id);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.sessions.find(id);
+        if (it == shard.sessions.end()) return false;
+        int64_t now = now_ms();
+        if (expired(it->second, now)) {
+            erase_entry(shard, it);
+            return false;
+        }
+        it->second.touch(now);
+        shard.bytes -= footprint(it->first, it->second.session);
+        fn(it->second.session);
+        shard.bytes += footprint(it->first, it->second.session);
+        journal_put(it);
+        return true;
+    }
+
+    size_t size() const {
+        size_t n = 0;
+        for (const Shard& shard : shards_) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            n += shard.sessions.size();
+        }
+        return n;
+    }
+
+    // Approximate heap bytes held by sessions (keys, strings, node overhead)
+    size_t memory_usage() const {
+        size_t n = 0;
+        for (const Shard& shard : shards_) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            n += shard.bytes;
+        }
+        return n;
+    }
+
+    // Visit the next `sweep_batch` buckets of every shard and drop expired
+    // sessions. Called by the sweeper thread; safe to call directly.
+    size_t sweep() {
+        size_t removed = 0;
+        int64_t now = now_ms();
+        for (Shard& shard : shards_) {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            size_t buckets = shard.sessions.bucket_count();
+            for (size_t i = 0; i < options_.sweep_batch && !shard.sessions.empty(); ++i) {
+                size_t b = shard.hand++ % buckets;
+                auto it = shard.sessions.begin(b);
+                while (it != shard.sessions.end(b)) {
+                    const std::string& id = (it++)->first;
+                    auto entry = shard.sessions.find(id);
+                    if (expired(entry->second, now)) {
+                        erase_entry(shard, entry);
+                        ++removed;
+                    }
+                }
+            }
+        }
+        return removed;
+    }
+
+    // Rebuild the store from journal records (oldest first), keeping each
+    // session's remaining idle time and dropping sessions that expired while
+    // the process was down. Shards are replayed in parallel. Call before
+    // attach_journal() and start_sweeper().
+    void restore(const std::vector<SessionRecord>& records) {
+        std::vector<std::vector<size_t>> by_shard(ShardCount);
+        for (size_t i = 0; i < records.size(); ++i) {
+            by_shard[shard_index(records[i].id)].push_back(i);
+        }
+
+        // Wall-clock times are mapped onto the steady clock used in memory
+        int64_t now = now_ms();
+        int64_t wall_now = wall_ms();
+        auto to_steady = [&](int64_t wall) {
+            return wall < wall_now ? now - (wall_now - wall) : now;
+        };
+
+        auto replay = [&](size_t first) {
+            for (size_t s = first; s < ShardCount; s += worker_count()) {
+                Shard& shard = shards_[s];
+                std::unique_lock<std::shared_mutex> lock(shard.mutex);
+                for (size_t i : by_shard[s]) {
+                    const SessionRecord& r = records[i];
+                    auto it = shard.sessions.find(r.id);
+                    if (r.type == SessionRecord::Touch) {
+                        int64_t t = to_steady(r.last_access_ms);
+                        if (it != shard.sessions.end() && t > it->second.last_access_ms.load()) {
+                            it->second.last_access_ms.store(t);
+                        }
+                        continue;
+                    }
+                    if (it != shard.sessions.end()) erase_entry(shard, it);
+                    if (r.type == SessionRecord::Erase) continue;
+                    it = shard.sessions.emplace(r.id, Entry(r.session, to_steady(r.last_access_ms)))
+                             .first;
+                    shard.bytes += footprint(it->first, it->second.session);
+                }
+                for (auto it = shard.sessions.begin(); it != shard.sessions.end();) {
+                    if (expired(it->second, now)) {
+                        shard.bytes -= footprint(it->first, it->second.session);
+                        it = shard.sessions.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+                while (shard.sessions.size() > max_per_shard_) evict_one(shard);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (size_t t = 1; t < worker_count(); ++t) workers.emplace_back(replay, t);
+        replay(0);
+        for (auto& w : workers) w.join();
+    }
+
+    // Report every later change to `journal`, which must outlive the store
+    void attach_journal(SessionJournal* journal) { journal_ = journal; }
+
+    // Rewrite the journal from the live sessions. Writers are blocked only
+    // while the sessions are copied; the file is written after the shard
+    // locks are released, and changes made meanwhile are carried over by the
+    // journal.
+    bool compact_journal() {
+        if (!journal_) return false;
+        std::lock_guard<std::mutex> compacting(compact_mutex_);
+        std::vector<SessionRecord> live;
+        size_t snapshot_end;
+        {
+            std::vector<std::shared_lock<std::shared_mutex>> locks;
+            int64_t now = now_ms();
+            int64_t wall_now = wall_ms();
+            for (Shard& shard : shards_) {
+                locks.emplace_back(shard.mutex);
+                for (const auto& kv : shard.sessions) {
+                    SessionRecord r;
+                    r.id = kv.first;
+                    r.session = kv.second.session;
+                    r.last_access_ms =
+                        wall_now - (now - kv.second.last_access_ms.load(std::memory_order_relaxed));
+                    live.push_back(std::move(r));
+                }
+            }
+            snapshot_end = journal_->size_bytes();
+        }
+        return journal_->compact(live, snapshot_end);
+    }
+
+    void start_sweeper() {
+        std::lock_guard<std::mutex> lock(sweeper_mutex_);
+        if (sweeper_.joinable()) return;
+        stop_ = false;
+        sweeper_ = std::thread([this] {
+            std::unique_lock<std::mutex> lock(sweeper_mutex_);
+            while (!stop_) {
+                sweeper_cv_.wait_for(lock, options_.sweep_interval);
+                if (stop_) break;
+                lock.unlock();
+                sweep();
+                maintain_journal();
+                lock.lock();
+            }
+        });
+    }
+
+    void stop_sweeper() {
+        {
+            std::lock_guard<std::mutex> lock(sweeper_mutex_);
+            if (!sweeper_.joinable()) return;
+            stop_ = true;
+        }
+        sweeper_cv_.notify_all();
+        sweeper_.join();
+    }
+
+private:
+    struct Entry {
+        Entry(Session s, int64_t now)
+            : session(std::move(s)), last_access_ms(now), journaled_ms(now), referenced(true) {}
+        Entry(Entry&& other) noexcept
+            : session(std::move(other.session)),
+              last_access_ms(other.last_access_ms.load()),
+              journaled_ms(other.journaled_ms.load()),
+              referenced(other.referenced.load()) {}
+
+        // Readers only hold the shared lock, so access stamps are atomic
+        void touch(int64_t now) const {
+            last_access_ms.store(now, std::memory_order_relaxed);
+            referenced.store(true, std::memory_order_relaxed);
+        }
+
+        Session session;
+        mutable std::atomic<int64_t> last_access_ms;
+        mutable std::atomic<int64_t> journaled_ms;  // last access time written to the journal
+        mutable std::atomic<bool> referenced;
+    };
+
+    // Cache-line aligned so neighbouring shard locks do not false-share
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, Entry> sessions;
+        size_t hand = 0;
+        size_t bytes = 0;
+    };
+
+    using Iterator = typename std::unordered_map<std::string, Entry>::iterator;
+
+    static int64_t now_ms() {
+        using namespace std::chrono;
+        return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    static int64_t wall_ms() {
+        using namespace std::chrono;
+        return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+    }
+
+    static size_t footprint(const std::string& id, const Session& s) {
+        const size_t node_overhead = sizeof(std::string) + sizeof(Entry) + 4 * sizeof(void*);
+        return node_overhead + id.capacity() + s.username.capacity() +
+               s.email.capacity() + s.csrf_token.capacity();
+    }
+
+    bool expired(const Entry& e, int64_t now) const {
+        auto ttl = std::chrono::duration_cast<std::chrono::milliseconds>(options_.ttl).count();
+        return now - e.last_access_ms.load(std::memory_order_relaxed) > ttl;
+    }
+
+    int64_t touch_interval_ms() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(options_.ttl).count() / 8;
+    }
+
+    void journal_put(Iterator it) {
+        if (!journal_) return;
+        it->second.journaled_ms.store(it->second.last_access_ms.load(std::memory_order_relaxed),
+                                      std::memory_order_relaxed);
+        journal_->record_put(it->first, it->second.session, wall_ms());
+    }
+
+    void erase_entry(Shard& shard, Iterator it) {
+        if (journal_) journal_->record_erase(it->first);
+        shard.bytes -= footprint(it->first, it->second.session);
+        shard.sessions.erase(it);
+    }
+
+    // CLOCK eviction: sweep buckets from the hand, clearing reference bits,
+    // and evict the first session that was not used since the last pass.
+    void evict_one(Shard& shard) {
+        size_t buckets = shard.sessions.bucket_count();
+        for (size_t pass = 0; pass < 2 * buckets + 1; ++pass) {
+            size_t b = shard.hand % buckets;
+            for (auto it = shard.sessions.begin(b); it != shard.sessions.end(b); ++it) {
+                if (!it->second.referenced.exchange(false, std::memory_order_relaxed)) {
+                    erase_entry(shard, shard.sessions.find(it->first));
+                    return;
+                }
+            }
+            ++shard.hand;
+        }
+        erase_entry(shard, shard.sessions.begin());
+    }
+
+    // Flush the journal, and compact it once it is at least twice the size
+    // of the live sessions
+    void maintain_journal() {
+        if (!journal_) return;
+        journal_->flush();
+        size_t logged = journal_->size_bytes();
+        if (logged > options_.compact_min_bytes && logged > 2 * memory_usage()) {
+            compact_journal();
+        }
+    }
+
+    static size_t worker_count() {
+        size_t n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : (n < ShardCount ? n : ShardCount);
+    }
+
+    static size_t shard_index(const std::string& id) {
+        return std::hash<std::string>()(id) % ShardCount;
+    }
+    Shard& shard_for(const std::string& id) { return shards_[shard_index(id)]; }
+    const Shard& shard_for(const std::string& id) const { return shards_[shard_index(id)]; }
+
+    SessionStoreOptions options_;
+    size_t max_per_shard_;
+    std::array<Shard, ShardCount> shards_;
+    SessionJournal* journal_ = nullptr;
+    std::mutex compact_mutex_;
+
+    std::mutex sweeper_mutex_;
+    std::condition_variable sweeper_cv_;
+    bool stop_ = false;
+    std::thread sweeper_;
+};
+
+#endif // SESSION_STORE_H
@@ -0,0 +1,68 @@
+#ifndef TOKEN_GENERATOR_H
+#define TOKEN_GENERATOR_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <sys/random.h>
+#include <sys/types.h>
+
+// Random token generator backed by the kernel CSPRNG.
+// Each thread keeps its own buffer of random bytes and refills it with one
+// getrandom() call per 4 KB, so generating a token is normally just a few
+// table lookups with no syscall, no locking and no generator seeding. Every
+// refill draws fresh kernel entropy, so there is no long-lived state to reseed.
+class TokenGenerator {
+public:
+    static constexpr char charset[] =
+        "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    static constexpr size_t charset_size = sizeof(charset) - 1;
+
+    // Fill `out[0..length)` with characters from `charset`
+    static void fill(char* out, size_t length) {
+        // Rejection sampling keeps the distribution uniform: only bytes below
+        // the largest multiple of 62 (248) are used
+        constexpr unsigned limit = 256 - 256 % charset_size;
+        Buffer& buf = buffer();
+        size_t i = 0;
+        while (i < length) {
+            if (buf.pos == sizeof(buf.bytes)) buf.refill();
+            unsigned char b = buf.bytes[buf.pos++];
+            if (b < limit) out[i++] = charset[b % charset_size];
+        }
+    }
+
+    static std::string generate(size_t length = 32) {
+        std::string token(length, '\0');
+        fill(&token[0], length);
+        return token;
+    }
+
+private:
+    struct Buffer {
+        unsigned char bytes[4096];
+        size_t pos = sizeof(bytes);
+
+        void refill() {
+            size_t got = 0;
+            while (got < sizeof(bytes)) {
+                ssize_t n = getrandom(bytes + got, sizeof(bytes) - got, 0);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    throw std::runtime_error("getrandom failed");
+                }
+                got += static_cast<size_t>(n);
+            }
+            pos = 0;
+        }
+    };
+
+    static Buffer& buffer() {
+        thread_local Buffer buf;
+        return buf;
+    }
+};
+
+#endif // TOKEN_GENERATOR_H
@@ -2,6 +2,8 @@
 #include <cstdlib>
 #include <string>
 #include "httplib.h"
+#include "process_runner.h"
+#include "reachability_prober.h"
 
 // Basic HTML UI for entering a hostname
 const char* html_form = R"(
@@ -12,7 +14,7 @@ const char* html_form = R"(
 </head>
 <body>
   <h2>Ping a Host</h2>
-  <form action="/ping" method="get">
+  <form action="%ACTION%" method="get">
     Host: <input name="host" type="text" />
     <input type="submit" value="Ping" />
   </form>
@@ -21,45 +23,114 @@ const char* html_form = R"(
 </html>
 )";
 
+// Form page whose form submits to `action`, output area still empty
+std::string form_page(const std::string& action) {
+    std::string page(html_form);
+    size_t pos = page.find("%ACTION%");
+    if (pos != std::string::npos)
+        page.replace(pos, 8, action);
+    return page;
+}
+
+// Fill the form page's output area
+std::string render_page(const std::string& output, const std::string& action = "/ping") {
+    std::string page = form_page(action);
+    size_t pos = page.find("%OUTPUT%");
+    if (pos != std::string::npos)
+        page.replace(pos, 8, output);
+    return page;
+}
+
+// Stream the page while `args` runs: the part before the output area first,
+// then the child's output as it is produced, then the rest of the page.
+// Only one 4 KB read buffer is held per request, whatever the output size.
+void stream_command(httplib::Response& res, std::vector<std::string> args, bool escape,
+                    const std::string& action) {
+    std::string page = form_page(action);
+    res.set_chunked_content_provider("text/html", [args, escape, page](size_t, httplib::DataSink& sink) {
+        size_t pos = page.find("%OUTPUT%");
+        if (!sink.write(page.data(), pos)) return false;
+
+        // A failed write means the client is gone: returning false from the
+        // output handler kills the child, and the provider stops here too
+        bool connected = true;
+        std::string escaped;
+        ProcessResult result = run_process(args, std::chrono::seconds(10),
+                                           [&](int fd, const char* data, size_t len) {
+            if (!escape) {
+                // Vulnerable handler shows stdout only, as the shell redirect did
+                if (fd != 1) return true;
+                return connected = sink.write(data, len);
+            }
+            escaped.clear();
+            httplib::detail::escape_html(data, len, escaped);
+            return connected = sink.write(escaped.data(), escaped.size());
+        });
+        if (!connected) return false;
+        if (!result.started && !sink.write("Failed to run ping.", 19)) return false;
+
+        if (!sink.write(page.data() + pos + 8, page.size() - pos - 8)) return false;
+        sink.done();
+        return true;
+    });
+}
+
 int main() {
     httplib::Server svr;
 
+    // Running and waiting pings each hold a worker thread, so together they
+    // may take at most half the pool; the rest stays free for other routes.
+    // At most 8 ping children at once, 8 more requests may wait for a slot.
+    constexpr size_t pool_size = 32;
+    constexpr size_t ping_slots = 8;
+    svr.new_task_queue = [] { return new httplib::ThreadPool(pool_size); };
+    httplib::ConcurrencyLimiter ping_limiter(ping_slots, pool_size / 2 - ping_slots);
+
     // Show form
     svr.Get("/", [](const httplib::Request& req, httplib::Response& res) {
-        std::string page(html_form);
-        size_t pos = page.find("%OUTPUT%");
-        if (pos != std::string::npos)
-            page.replace(pos, 9, ""); // no output yet
-        res.set_content(page, "text/html");
+        res.set_content(render_page(""), "text/html"); // no output yet
     });
 
     // Vulnerable handler
-    svr.Get("/ping", [](const httplib::Request& req, httplib::Response& res) {
+    svr.Get("/ping", ping_limiter.wrap([](const httplib::Request& req, httplib::Response& res) {
         std::string host = req.get_param_value("host");
 
-        // ❌ Unsafe: user input is passed directly to system()
-        std::string cmd = "ping -c 2 " + host + " > output.txt";
-        int ret = system(cmd.c_str());
+        // ❌ Unsafe: user input is passed directly to a shell
+        std::string cmd = "ping -c 2 " + host;
+        stream_command(res, {"/bin/sh", "-c", cmd}, false, "/ping");
+    }));
 
-        std::string output;
-        FILE* fp = fopen("output.txt", "r");
-        if (fp) {
-            char buf[1024];
-            while (fgets(buf, sizeof(buf), fp)) {
-                output += buf;
-            }
-            fclose(fp);
-        } else {
-            output = "Failed to run ping.";
+    // Safe handler: no shell, the host is a single argv entry
+    svr.Get("/ping2", ping_limiter.wrap([](const httplib::Request& req, httplib::Response& res) {
+        std::string host = req.get_param_value("host");
+
+        // A leading '-' would be parsed by ping as an option
+        if (host.empty() || host[0] == '-') {
+            res.status = 400;
+            res.set_content(render_page("Invalid host.", "/ping2"), "text/html");
+            return;
         }
 
-        std::string page(html_form);
-        size_t pos = page.find("%OUTPUT%");
-        if (pos != std::string::npos)
-            page.replace(pos, 9, output);
+        stream_command(res, {"ping", "-c", "2", host}, true, "/ping2");
+    }));
 
-        res.set_content(page, "text/html");
-    });
+    // Reachability check without spawning any process
+    // Concurrent checks of the same host share one probe
+    ReachabilityProber prober;
+    httplib::RequestCoalescer reach_coalescer;
+    svr.Get("/reach", reach_coalescer.wrap([&](const httplib::Request& req, httplib::Response& res) {
+        std::string host = req.get_param_value("host");
+        ProbeResult result = prober.check(host);
+
+        std::string output = host + (result.reachable ? " is reachable" : " is unreachable");
+        if (!result.method.empty()) output += " (" + result.method + ")";
+        if (result.reachable) {
+            output += ", " + std::to_string(result.rtt_ms) + " ms";
+        } else if (!result.error.empty()) {
+            output += ": " + result.error;
+        }
+        res.set_content(render_page(httplib::escape_html(output), "/reach"), "text/html");
+    }));
 
     std::cout << "Running on http://localhost:8080\n";
     svr.listen("0.0.0.0", 8080);
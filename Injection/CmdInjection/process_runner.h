@@ -0,0 +1,147 @@
+#ifndef PROCESS_RUNNER_H
+#define PROCESS_RUNNER_H
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+struct ProcessResult {
+    bool started = false;    // false if the program could not be launched
+    bool timed_out = false;  // killed after the timeout expired
+    int exit_code = -1;      // exit status, or -1 if killed by a signal
+    std::string out;         // captured stdout (run_process without a handler)
+    std::string err;         // captured stderr
+};
+
+// Called with each block of child output as it arrives; `fd` is 1 for stdout
+// and 2 for stderr. Return false to stop early (the child is killed).
+using ProcessOutputHandler = std::function<bool(int fd, const char* data, size_t len)>;
+
+// Reap `pid` if it exits before `deadline`, polling with a growing pause
+// (1 ms up to 16 ms). Returns false if it is still running at the deadline.
+inline bool wait_for_exit(pid_t pid, std::chrono::steady_clock::time_point deadline,
+                          int& status) {
+    std::chrono::steady_clock::duration pause = std::chrono::milliseconds(1);
+    while (true) {
+        pid_t r = waitpid(pid, &status, WNOHANG);
+        if (r == pid || (r < 0 && errno != EINTR)) return true;
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) return false;
+        std::this_thread::sleep_for(std::min(pause, deadline - now));
+        if (pause < std::chrono::milliseconds(16)) pause *= 2;
+    }
+}
+
+// Launch argv[0] (searched in PATH) directly with posix_spawn - no shell -
+// and pass its stdout/stderr through pipes to `on_output`. The child is
+// killed if it runs longer than `timeout`. Each call owns its own pipes, so
+// any number of children can run concurrently.
+inline ProcessResult run_process(const std::vector<std::string>& args,
+                                 std::chrono::milliseconds timeout,
+                                 const ProcessOutputHandler& on_output) {
+    ProcessResult result;
+    if (args.empty()) return result;
+
+    // O_CLOEXEC: pipes of other concurrent spawns must not leak into this child
+    int out_pipe[2], err_pipe[2];
+    if (pipe2(out_pipe, O_CLOEXEC) != 0) return result;
+    if (pipe2(err_pipe, O_CLOEXEC) != 0) {
+        close(out_pipe[0]);
+        close(out_pipe[1]);
+        return result;
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, 0, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, out_pipe[1], 1);
+    posix_spawn_file_actions_adddup2(&actions, err_pipe[1], 2);
+
+    std::vector<char*> argv;
+    for (const std::string& a : args) argv.push_back(const_cast<char*>(a.c_str()));
+    argv.push_back(nullptr);
+
+    pid_t pid;
+    int rc = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(out_pipe[1]);
+    close(err_pipe[1]);
+    if (rc != 0) {
+        close(out_pipe[0]);
+        close(err_pipe[0]);
+        return result;
+    }
+    result.started = true;
+
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    pollfd fds[2] = {{out_pipe[0], POLLIN, 0}, {err_pipe[0], POLLIN, 0}};
+    int open_fds = 2;
+    bool stop = false;
+    char buf[4096];
+    while (open_fds > 0 && !stop) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (left <= 0) {
+            result.timed_out = true;
+            break;
+        }
+        int n = poll(fds, 2, static_cast<int>(left));
+        if (n < 0 && errno != EINTR) break;
+        for (int i = 0; i < 2 && n > 0; ++i) {
+            if (fds[i].fd < 0 || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            ssize_t len = read(fds[i].fd, buf, sizeof(buf));
+            if (len > 0) {
+                if (!on_output(i + 1, buf, static_cast<size_t>(len))) stop = true;
+            } else if (len == 0 || errno != EINTR) {
+                close(fds[i].fd);
+                fds[i].fd = -1;  // poll ignores negative fds
+                --open_fds;
+            }
+        }
+    }
+
+    for (const pollfd& p : fds) {
+        if (p.fd >= 0) close(p.fd);
+    }
+
+    // EOF on both pipes usually means the child has exited, but it may have
+    // closed them and kept running, so it still only gets until the deadline
+    int status = 0;
+    bool exited = open_fds == 0 && wait_for_exit(pid, deadline, status);
+    if (!exited) {
+        if (open_fds == 0) result.timed_out = true;
+        kill(pid, SIGKILL);
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+        }
+    }
+    if (WIFEXITED(status)) result.exit_code = WEXITSTATUS(status);
+    return result;
+}
+
+// Same, collecting stdout and stderr into the result
+inline ProcessResult run_process(const std::vector<std::string>& args,
+                                 std::chrono::milliseconds timeout) {
+    std::string out, err;
+    ProcessResult result = run_process(args, timeout, [&](int fd, const char* data, size_t len) {
+        (fd == 1 ? out : err).append(data, len);
+        return true;
+    });
+    result.out = std::move(out);
+    result.err = std::move(err);
+    return result;
+}
+
+#endif // PROCESS_RUNNER_H
@@ -0,0 +1,363 @@
+#ifndef REACHABILITY_PROBER_H
+#define REACHABILITY_PROBER_H
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/ip_icmp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+struct ProbeResult {
+    bool reachable = false;
+    std::string method;  // "icmp" or "tcp"
+    double rtt_ms = 0;
+    std::string error;   // why the host is considered unreachable
+};
+
+// In-process reachability checks, without spawning /bin/ping.
+//
+// Each probe sends one ICMP echo request on an unprivileged datagram ICMP
+// socket (Linux, if net.ipv4.ping_group_range allows it) and otherwise falls
+// back to a TCP connect to `tcp_port`; a refused connection still proves the
+// host is up. All probes are multiplexed on one epoll thread with individual
+// deadlines. Results are cached per host for `cache_ttl`, at most
+// max_cache_entries hosts.
+class ReachabilityProber {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t max_cache_entries = 4096;
+
+    explicit ReachabilityProber(std::chrono::milliseconds timeout = std::chrono::milliseconds(2000),
+                                std::chrono::milliseconds cache_ttl = std::chrono::milliseconds(5000),
+                                uint16_t tcp_port = 80)
+        : timeout_(timeout), cache_ttl_(cache_ttl), tcp_port_(tcp_port) {
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd_ < 0) throw std::runtime_error(error_text("cannot create epoll instance"));
+        wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd_ < 0) {
+            std::string error = error_text("cannot create eventfd");
+            close(epoll_fd_);
+            throw std::runtime_error(error);
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = wake_fd_;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev) != 0) {
+            std::string error = error_text("cannot watch eventfd");
+            close(wake_fd_);
+            close(epoll_fd_);
+            throw std::runtime_error(error);
+        }
+        worker_ = std::thread([this] { run(); });
+    }
+
+    ~ReachabilityProber() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake();
+        worker_.join();
+        close(wake_fd_);
+        close(epoll_fd_);
+    }
+
+    ReachabilityProber(const ReachabilityProber&) = delete;
+    ReachabilityProber& operator=(const ReachabilityProber&) = delete;
+
+    // Probe `host` (name or address), or return the cached result if it is
+    // fresh. Blocks the caller until the probe finishes or times out; the
+    // name lookup also runs on the calling thread.
+    ProbeResult check(const std::string& host) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = cache_.find(host);
+            if (it != cache_.end() && Clock::now() < it->second.expires) return it->second.result;
+        }
+
+        ProbeResult result;
+        sockaddr_storage addr;
+        socklen_t addr_len = 0;
+        if (!resolve(host, addr, addr_len)) {
+            result.error = "cannot resolve host";
+        } else {
+            result = submit(addr, addr_len).get();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        store(host, result);
+        return result;
+    }
+
+    // Number of hosts currently cached
+    size_t cache_size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cache_.size();
+    }
+
+private:
+    struct Request {
+        sockaddr_storage addr;
+        socklen_t addr_len;
+        std::promise<ProbeResult> promise;
+    };
+
+    struct Probe {
+        bool icmp;
+        Clock::time_point start;
+        std::multimap<Clock::time_point, int>::iterator deadline;
+        std::promise<ProbeResult> promise;
+    };
+
+    struct CacheEntry {
+        ProbeResult result;
+        Clock::time_point expires;
+        std::multimap<Clock::time_point, std::string>::iterator expiry;
+    };
+
+    static std::string error_text(const char* what) {
+        return std::string(what) + ": " + std::strerror(errno);
+    }
+
+    static bool resolve(const std::string& host, sockaddr_storage& addr, socklen_t& addr_len) {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* res = nullptr;
+        if (getaddrinfo(host.c_str(), nullptr, &hints, &res) != 0 || !res) return false;
+        std::memcpy(&addr, res->ai_addr, res->ai_addrlen);
+        addr_len = res->ai_addrlen;
+        freeaddrinfo(res);
+        return true;
+    }
+
+    std::future<ProbeResult> submit(const sockaddr_storage& addr, socklen_t addr_len) {
+        Request req{addr, addr_len, std::promise<ProbeResult>()};
+        std::future<ProbeResult> result = req.promise.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.push_back(std::move(req));
+        }
+        wake();
+        return result;
+    }
+
+    void wake() {
+        uint64_t one = 1;
+        ssize_t n = write(wake_fd_, &one, sizeof(one));
+        (void)n;
+    }
+
+    // Cache `result` for `host`, then drop expired entries and, past
+    // max_cache_entries, the ones closest to expiry. Every entry is indexed
+    // by expiry time, so each eviction is O(log n). Caller holds mutex_.
+    void store(const std::string& host, const ProbeResult& result) {
+        auto now = Clock::now();
+        auto it = cache_.find(host);
+        if (it == cache_.end()) {
+            it = cache_.emplace(host, CacheEntry()).first;
+        } else {
+            expiry_.erase(it->second.expiry);
+        }
+        it->second.result = result;
+        it->second.expires = now + cache_ttl_;
+        it->second.expiry = expiry_.emplace(it->second.expires, host);
+
+        while (!expiry_.empty() &&
+               (cache_.size() > max_cache_entries || expiry_.begin()->first <= now)) {
+            cache_.erase(expiry_.begin()->second);
+            expiry_.erase(expiry_.begin());
+        }
+    }
+
+    // ---- epoll thread ----
+
+    void run() {
+        std::vector<epoll_event> events(64);
+        while (true) {
+            int wait_ms = -1;
+            if (!deadlines_.empty()) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadlines_.begin()->first - Clock::now()).count();
+                wait_ms = left > 0 ? static_cast<int>(left) + 1 : 0;
+            }
+            int n = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), wait_ms);
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == wake_fd_) {
+                    uint64_t count;
+                    ssize_t r = read(wake_fd_, &count, sizeof(count));
+                    (void)r;
+                } else {
+                    on_ready(fd);
+                }
+            }
+
+            std::vector<Request> batch;
+            bool stopping;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                batch.swap(pending_);
+                stopping = stop_;
+            }
+            for (Request& req : batch) start(req);
+
+            auto now = Clock::now();
+            while (!deadlines_.empty() && (stopping || deadlines_.begin()->first <= now)) {
+                int fd = deadlines_.begin()->second;
+                ProbeResult r;
+                r.method = probes_[fd].icmp ? "icmp" : "tcp";
+                r.error = stopping ? "prober stopped" : "timed out";
+                finish(fd, std::move(r));
+            }
+            if (stopping) return;
+        }
+    }
+
+    void start(Request& req) {
+        int fd = -1;
+        bool icmp = false;
+        if (req.addr.ss_family == AF_INET) {
+            fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_ICMP);
+            icmp = fd >= 0;
+        }
+
+        ProbeResult r;
+        if (icmp) {
+            // The kernel fills in the identifier and checksum on ping sockets
+            icmphdr echo{};
+            echo.type = ICMP_ECHO;
+            echo.un.echo.sequence = htons(++sequence_);
+            if (sendto(fd, &echo, sizeof(echo), 0, reinterpret_cast<sockaddr*>(&req.addr),
+                       req.addr_len) < 0) {
+                // e.g. EPERM from a firewall rule: try the TCP connect instead
+                close(fd);
+                icmp = false;
+            }
+        }
+        if (!icmp) {
+            r.method = "tcp";
+            set_port(req.addr, tcp_port_);
+            fd = socket(req.addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (fd < 0) {
+                r.error = std::strerror(errno);
+                req.promise.set_value(std::move(r));
+                return;
+            }
+            if (connect(fd, reinterpret_cast<sockaddr*>(&req.addr), req.addr_len) == 0 ||
+                errno == ECONNREFUSED) {
+                r.reachable = true;
+                close(fd);
+                req.promise.set_value(std::move(r));
+                return;
+            }
+            if (errno != EINPROGRESS) {
+                r.error = std::strerror(errno);
+                close(fd);
+                req.promise.set_value(std::move(r));
+                return;
+            }
+        }
+
+        epoll_event ev{};
+        ev.events = icmp ? EPOLLIN : EPOLLOUT;
+        ev.data.fd = fd;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+
+        Probe& p = probes_[fd];
+        p.icmp = icmp;
+        p.start = Clock::now();
+        p.deadline = deadlines_.emplace(p.start + timeout_, fd);
+        p.promise = std::move(req.promise);
+    }
+
+    void on_ready(int fd) {
+        auto it = probes_.find(fd);
+        if (it == probes_.end()) return;
+
+        ProbeResult r;
+        if (it->second.icmp) {
+            r.method = "icmp";
+            icmphdr reply{};
+            ssize_t n = recv(fd, &reply, sizeof(reply), 0);
+            if (n < 0 && (errno == EAGAIN || errno == EINTR)) return;
+            if (n >= static_cast<ssize_t>(sizeof(reply)) && reply.type == ICMP_ECHOREPLY) {
+                r.reachable = true;
+            } else {
+                r.error = n < 0 ? std::strerror(errno) : "unexpected ICMP reply";
+            }
+        } else {
+            r.method = "tcp";
+            int err = 0;
+            socklen_t len = sizeof(err);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len);
+            if (err == 0 || err == ECONNREFUSED) {
+                r.reachable = true;
+            } else {
+                r.error = std::strerror(err);
+            }
+        }
+        finish(fd, std::move(r));
+    }
+
+    void finish(int fd, ProbeResult r) {
+        auto it = probes_.find(fd);
+        Probe& p = it->second;
+        if (r.reachable) {
+            r.rtt_ms = std::chrono::duration<double, std::milli>(Clock::now() - p.start).count();
+        }
+        p.promise.set_value(std::move(r));
+        deadlines_.erase(p.deadline);
+        probes_.erase(it);
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+    }
+
+    static void set_port(sockaddr_storage& addr, uint16_t port) {
+        if (addr.ss_family == AF_INET) {
+            reinterpret_cast<sockaddr_in*>(&addr)->sin_port = htons(port);
+        } else if (addr.ss_family == AF_INET6) {
+            reinterpret_cast<sockaddr_in6*>(&addr)->sin6_port = htons(port);
+        }
+    }
+
+    std::chrono::milliseconds timeout_;
+    std::chrono::milliseconds cache_ttl_;
+    uint16_t tcp_port_;
+
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+
+    // Shared with request threads
+    std::mutex mutex_;
+    std::vector<Request> pending_;
+    std::unordered_map<std::string, CacheEntry> cache_;
+    std::multimap<Clock::time_point, std::string> expiry_;  // cache_ keys by expiry
+    bool stop_ = false;
+
+    // Owned by the epoll thread
+    std::unordered_map<int, Probe> probes_;
+    std::multimap<Clock::time_point, int> deadlines_;
+    uint16_t sequence_ = 0;
+
+    std::thread worker_;
+};
+
+#endif // REACHABILITY_PROBER_H
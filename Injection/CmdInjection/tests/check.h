@@ -0,0 +1,24 @@
+#ifndef TESTS_CHECK_H
+#define TESTS_CHECK_H
+
+// Test helpers shared by the programs in this directory. Each check prints
+// "ok" or "FAIL" with its label; main returns check_result().
+
+#include <cstdio>
+
+inline int& check_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline bool expect(const char* label, bool ok) {
+    std::printf("%s %s\n", ok ? "ok  " : "FAIL", label);
+    if (!ok) check_failures()++;
+    return ok;
+}
+
+inline int check_result() {
+    return check_failures() == 0 ? 0 : 1;
+}
+
+#endif // TESTS_CHECK_H
@@ -0,0 +1,45 @@
+// Checks run_process: normal exit, the timeout while the child still holds
+// its pipes, the timeout after the child closed them but kept running, and
+// a program that cannot be launched. Exits non-zero on failure.
+//
+//   cd Injection/CmdInjection/tests && g++ -std=c++14 -O2 -I.. process_runner_test.cpp -o process_runner_test -pthread
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "process_runner.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Runs `args` with `timeout` and returns the result, with the wall time it
+// took in `elapsed`
+static ProcessResult run(const std::vector<std::string>& args, std::chrono::milliseconds timeout,
+                         std::chrono::milliseconds& elapsed) {
+    auto start = Clock::now();
+    ProcessResult r = run_process(args, timeout);
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+    return r;
+}
+
+int main() {
+    std::chrono::milliseconds elapsed(0);
+
+    ProcessResult r = run({"echo", "hi"}, std::chrono::milliseconds(2000), elapsed);
+    expect("exits normally", r.started && !r.timed_out && r.exit_code == 0 && r.out == "hi\n");
+
+    r = run({"sleep", "5"}, std::chrono::milliseconds(500), elapsed);
+    expect("killed while its output is open",
+           r.started && r.timed_out && elapsed < std::chrono::milliseconds(1500));
+
+    // Closing stdout/stderr gives EOF long before the child exits; the wait
+    // for it must still end at the deadline
+    r = run({"sh", "-c", "echo hi; exec >&- 2>&-; sleep 5"}, std::chrono::milliseconds(500), elapsed);
+    expect("killed after closing its output",
+           r.started && r.timed_out && r.out == "hi\n" && elapsed < std::chrono::milliseconds(1500));
+
+    r = run({"no-such-program-xyz"}, std::chrono::milliseconds(500), elapsed);
+    expect("missing program is not started", !r.started);
+
+    return check_result();
+}
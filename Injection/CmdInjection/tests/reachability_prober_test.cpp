@@ -0,0 +1,68 @@
+// Checks ReachabilityProber: a closed port on 127.0.0.1 counts as reachable,
+// an unroutable address times out, a repeated check within the TTL comes
+// from the cache, and the cache stays within max_cache_entries hosts. Exits
+// non-zero on failure.
+//
+//   cd Injection/CmdInjection/tests && g++ -std=c++14 -O2 -I.. reachability_prober_test.cpp -o reachability_prober_test -pthread
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "check.h"
+#include "reachability_prober.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Checks `host` and returns the result, with the wall time it took in
+// `elapsed`
+static ProbeResult check(ReachabilityProber& prober, const std::string& host,
+                         std::chrono::milliseconds& elapsed) {
+    auto start = Clock::now();
+    ProbeResult r = prober.check(host);
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+    return r;
+}
+
+int main() {
+    std::chrono::milliseconds elapsed(0);
+
+    // Nothing listens on port 1, so a TCP probe is refused; ICMP, where the
+    // sandbox allows ping sockets, gets an echo reply
+    ReachabilityProber local(std::chrono::milliseconds(1000), std::chrono::milliseconds(5000), 1);
+    ProbeResult r = check(local, "127.0.0.1", elapsed);
+    expect("closed port on 127.0.0.1 is reachable",
+           r.reachable && r.error.empty() && (r.method == "tcp" || r.method == "icmp"));
+
+    // Nothing answers 10.255.255.1; a host without any route to it fails
+    // the connect at once instead of waiting for the deadline
+    ReachabilityProber remote(std::chrono::milliseconds(300), std::chrono::milliseconds(5000), 80);
+    r = check(remote, "10.255.255.1", elapsed);
+    bool timed_out = r.error == "timed out" && elapsed.count() >= 250;
+    bool no_route = r.error == std::strerror(ENETUNREACH) || r.error == std::strerror(EHOSTUNREACH);
+    expect("unroutable address times out", !r.reachable && (timed_out || no_route));
+    if (!timed_out) printf("     (no route here: %s)\n", r.error.c_str());
+
+    ProbeResult again = check(remote, "10.255.255.1", elapsed);
+    expect("second check within the TTL is a cache hit",
+           elapsed.count() < 100 && !again.reachable && again.error == r.error &&
+               again.method == r.method && remote.cache_size() == 1);
+
+    ReachabilityProber bounded(std::chrono::milliseconds(1000), std::chrono::minutes(10), 1);
+    bool all_answered = true;
+    bool within_bound = true;
+    for (int i = 0; i < 5000; ++i) {
+        std::string host = "127.0." + std::to_string(i / 250) + "." + std::to_string(i % 250 + 1);
+        all_answered = all_answered && bounded.check(host).reachable;
+        within_bound = within_bound && bounded.cache_size() <= ReachabilityProber::max_cache_entries;
+    }
+    expect("5000 hosts leave at most max_cache_entries cached",
+           all_answered && within_bound &&
+               bounded.cache_size() == ReachabilityProber::max_cache_entries);
+
+    expect("unresolvable host", !local.check("no-such-host.invalid").reachable &&
+                                    local.check("no-such-host.invalid").error == "cannot resolve host");
+
+    return check_result();
+}
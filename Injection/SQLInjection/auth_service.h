@@ -0,0 +1,171 @@
+#ifndef AUTH_SERVICE_H
+#define AUTH_SERVICE_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "user_db.h"
+
+struct AuthResult {
+    bool ok = false;
+    std::string username;
+};
+
+// Checks credentials in batches on a dedicated DB thread.
+// Requests queued together (up to `max_batch`) are resolved by a single
+//   SELECT username, password FROM users WHERE username IN (?, ?, ...)
+// and each caller's future is completed from the rows it returns. A lone
+// request is looked up at once. When several are already waiting, the batch
+// stays open for more while they keep arriving, but no longer than `window`
+// in total and no longer than window / 8 after the last arrival. Requests
+// that arrive while a query runs form the next batch. If the lookup throws,
+// the exception is delivered through the futures of that batch.
+class AuthService {
+public:
+    explicit AuthService(UserDb& db,
+                         std::chrono::microseconds window = std::chrono::microseconds(500),
+                         size_t max_batch = 64)
+        : db_(db), window_(window), max_batch_(max_batch ? max_batch : 1),
+          worker_([this] { run(); }) {}
+
+    ~AuthService() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        worker_.join();
+    }
+
+    AuthService(const AuthService&) = delete;
+    AuthService& operator=(const AuthService&) = delete;
+
+    std::future<AuthResult> submit(std::string username, std::string password) {
+        Pending p{std::move(username), std::move(password), std::promise<AuthResult>()};
+        std::future<AuthResult> result = p.promise.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(p));
+        }
+        cv_.notify_one();
+        return result;
+    }
+
+private:
+    struct Pending {
+        std::string username;
+        std::string password;
+        std::promise<AuthResult> promise;
+    };
+
+    void run() {
+        std::vector<Pending> batch;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) return;  // stopping with nothing left to do
+
+            // Logins are arriving concurrently: give others a moment to join
+            if (queue_.size() > 1) {
+                auto deadline = std::chrono::steady_clock::now() + window_;
+                while (queue_.size() < max_batch_) {
+                    size_t seen = queue_.size();
+                    auto until = std::min(deadline, std::chrono::steady_clock::now() + window_ / 8);
+                    bool arrived = cv_.wait_until(lock, until, [&] {
+                        return stop_ || queue_.size() != seen;
+                    });
+                    if (!arrived || stop_ || std::chrono::steady_clock::now() >= deadline) break;
+                }
+            }
+
+            size_t n = queue_.size() < max_batch_ ? queue_.size() : max_batch_;
+            batch.clear();
+            for (size_t i = 0; i < n; ++i) batch.push_back(std::move(queue_[i]));
+            queue_.erase(queue_.begin(), queue_.begin() + static_cast<std::ptrdiff_t>(n));
+
+            lock.unlock();
+            try {
+                resolve(batch);
+            } catch (...) {
+                fail(batch, std::current_exception());
+            }
+            lock.lock();
+        }
+    }
+
+    void resolve(std::vector<Pending>& batch) {
+        // Distinct usernames become the IN (...) list
+        std::unordered_set<std::string> seen;
+        std::vector<const std::string*> names;
+        for (const Pending& p : batch) {
+            if (seen.insert(p.username).second) names.push_back(&p.username);
+        }
+
+        std::unordered_map<std::string, std::string> stored;  // username -> password
+        CachedStatement stmt = db_.statement(lookup_sql(names.size()));
+        bool ok = static_cast<bool>(stmt);
+        if (ok) {
+            for (size_t i = 0; i < names.size(); ++i) {
+                stmt.bind(static_cast<int>(i + 1), *names[i]);
+            }
+            int rc;
+            while ((rc = stmt.step()) == SQLITE_ROW) {
+                stored[stmt.column_text(0)] = stmt.column_text(1);
+            }
+            ok = rc == SQLITE_DONE;
+        }
+
+        for (Pending& p : batch) {
+            AuthResult r;
+            auto it = stored.find(p.username);
+            if (ok && it != stored.end() && it->second == p.password) {
+                r.ok = true;
+                r.username = p.username;
+            }
+            p.promise.set_value(std::move(r));
+        }
+    }
+
+    // Complete every future of `batch` not completed yet with `error`
+    static void fail(std::vector<Pending>& batch, std::exception_ptr error) {
+        for (Pending& p : batch) {
+            try {
+                p.promise.set_exception(error);
+            } catch (const std::future_error&) {
+                // already has its result
+            }
+        }
+    }
+
+    // One statement text per batch size, so each size is compiled once
+    static std::string lookup_sql(size_t n) {
+        std::string sql = "SELECT username, password FROM users WHERE username IN (";
+        for (size_t i = 0; i < n; ++i) {
+            if (i) sql += ',';
+            sql += '?';
+        }
+        sql += ");";
+        return sql;
+    }
+
+    UserDb& db_;
+    std::chrono::microseconds window_;
+    size_t max_batch_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Pending> queue_;
+    bool stop_ = false;
+    std::thread worker_;
+};
+
+#endif // AUTH_SERVICE_H
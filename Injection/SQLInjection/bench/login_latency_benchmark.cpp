@@ -0,0 +1,121 @@
+// Login latency as the users table grows, from 1k to 1M rows (or the
+// size given on the command line):
+//
+//   no index    the original schema, where every lookup scans the table
+//   indexed     the unique index on username, cached statement per thread
+//   auth        AuthService, one client at a time
+//   auth x8     AuthService, eight clients at once (batched lookups)
+//
+// Prints the median and 99th percentile in microseconds.
+//
+//   cd Injection/SQLInjection/bench && g++ -std=c++17 -O2 -I.. login_latency_benchmark.cpp -o login_latency_benchmark -lsqlite3 -pthread
+//
+//   ./login_latency_benchmark [max_users]   (default 1000000)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "auth_service.h"
+#include "user_db.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct Latency {
+    double p50_us = 0;
+    double p99_us = 0;
+};
+
+Latency summarize(std::vector<double>& samples) {
+    Latency l;
+    if (samples.empty()) return l;
+    std::sort(samples.begin(), samples.end());
+    l.p50_us = samples[samples.size() / 2];
+    l.p99_us = samples[samples.size() * 99 / 100];
+    return l;
+}
+
+// Times `login(username, password)` for random seeded users until `budget`
+// has passed (at least 20 logins), on `clients` threads at once
+template <typename Login>
+Latency measure(size_t users, int clients, std::chrono::milliseconds budget, Login login) {
+    std::vector<std::vector<double>> per_client(clients);
+    std::vector<std::thread> threads;
+    bool failed = false;
+    std::mutex failed_mutex;
+    auto start = Clock::now();
+    for (int c = 0; c < clients; ++c) {
+        threads.emplace_back([&, c] {
+            unsigned seed = 777u + static_cast<unsigned>(c);
+            auto& samples = per_client[c];
+            while (samples.size() < 20 || Clock::now() - start < budget) {
+                seed = seed * 1103515245u + 12345u;
+                std::string id = std::to_string(1 + (seed >> 8) % users);
+                auto t0 = Clock::now();
+                bool ok = login("user" + id, "pass" + id);
+                samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+                if (!ok) {
+                    std::lock_guard<std::mutex> lock(failed_mutex);
+                    failed = true;
+                }
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    if (failed) std::printf("a login failed\n");
+
+    std::vector<double> all;
+    for (auto& s : per_client) all.insert(all.end(), s.begin(), s.end());
+    return summarize(all);
+}
+
+bool login(UserDb& db, const std::string& username, const std::string& password) {
+    CachedStatement stmt =
+        db.statement("SELECT id, username FROM users WHERE username = ?1 AND password = ?2;");
+    if (!stmt) return false;
+    stmt.bind(1, username);
+    stmt.bind(2, password);
+    return stmt.step() == SQLITE_ROW;
+}
+
+int main(int argc, char** argv) {
+    size_t max_users = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::chrono::milliseconds budget(300);
+
+    std::printf("%9s %11s | %17s | %17s | %17s | %17s\n", "", "", "no index", "indexed", "auth",
+                "auth x8");
+    std::printf("%9s %11s | %8s %8s | %8s %8s | %8s %8s | %8s %8s\n", "users", "seed ms", "p50",
+                "p99", "p50", "p99", "p50", "p99", "p50", "p99");
+    for (size_t users = 1000; users <= max_users; users *= 10) {
+        std::string name = "file:latency" + std::to_string(users) + "?mode=memory&cache=shared";
+        UserDb db(name);
+        db.exec("CREATE TABLE users (id INTEGER PRIMARY KEY, username TEXT, password TEXT);");
+        auto t0 = Clock::now();
+        db.seed_users(users);
+        double seed_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+        auto direct = [&](const std::string& u, const std::string& p) { return login(db, u, p); };
+        Latency scan = measure(users, 1, budget, direct);
+
+        db.exec("CREATE UNIQUE INDEX users_username ON users (username);");
+        Latency indexed = measure(users, 1, budget, direct);
+
+        Latency auth1, auth8;
+        {
+            AuthService auth(db);
+            auto batched = [&](const std::string& u, const std::string& p) {
+                return auth.submit(u, p).get().ok;
+            };
+            auth1 = measure(users, 1, budget, batched);
+            auth8 = measure(users, 8, budget, batched);
+        }
+
+        std::printf("%9zu %11.0f | %8.1f %8.1f | %8.1f %8.1f | %8.1f %8.1f | %8.1f %8.1f\n", users,
+                    seed_ms, scan.p50_us, scan.p99_us, indexed.p50_us, indexed.p99_us,
+                    auth1.p50_us, auth1.p99_us, auth8.p50_us, auth8.p99_us);
+    }
+    return 0;
+}
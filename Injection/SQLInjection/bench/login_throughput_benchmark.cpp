@@ -0,0 +1,126 @@
+// Login throughput at 1-16 threads: per-thread connections with a cached,
+// parameterized statement (UserDb, as /login2 used it before batching)
+// against the original path, which concatenated the query and ran
+// sqlite3_prepare_v2 / step / finalize on one connection shared by every
+// worker thread.
+//
+//   cd Injection/SQLInjection/bench && g++ -std=c++17 -O2 -I.. login_throughput_benchmark.cpp -o login_throughput_benchmark -lsqlite3 -pthread
+//
+//   ./login_throughput_benchmark [users]   (default 10000)
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sqlite3.h>
+#include "user_db.h"
+
+const char* const schema_sql =
+    "CREATE TABLE users (id INTEGER PRIMARY KEY, username TEXT, password TEXT);";
+const char* const index_sql = "CREATE UNIQUE INDEX users_username ON users (username);";
+
+namespace baseline {
+
+// One connection on a private :memory: database, shared by all threads
+// (SQLite's default serialized mode makes that safe, one call at a time)
+sqlite3* open_db(size_t users) {
+    sqlite3* db = nullptr;
+    if (sqlite3_open(":memory:", &db) != SQLITE_OK) throw std::runtime_error("open failed");
+    sqlite3_exec(db, schema_sql, nullptr, nullptr, nullptr);
+    sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+    for (size_t i = 1; i <= users; ++i) {
+        std::string n = std::to_string(i);
+        std::string sql = "INSERT INTO users (username, password) VALUES ('user" + n + "', 'pass" +
+                          n + "');";
+        sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr);
+    }
+    sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+    sqlite3_exec(db, index_sql, nullptr, nullptr, nullptr);
+    return db;
+}
+
+// The original /login body, minus the HTML
+bool login(sqlite3* db, const std::string& username, const std::string& password) {
+    std::string query = "SELECT * FROM users WHERE username = '" + username +
+                        "' AND password = '" + password + "';";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) return false;
+    bool ok = sqlite3_step(stmt) == SQLITE_ROW;
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+} // namespace baseline
+
+bool login(UserDb& db, const std::string& username, const std::string& password) {
+    CachedStatement stmt =
+        db.statement("SELECT id, username FROM users WHERE username = ?1 AND password = ?2;");
+    if (!stmt) return false;
+    stmt.bind(1, username);
+    stmt.bind(2, password);
+    return stmt.step() == SQLITE_ROW;
+}
+
+// Runs `threads` threads for about `duration`, each logging in as random
+// seeded users, and returns logins per second
+template <typename Login>
+double logins_per_sec(int threads, size_t users, std::chrono::milliseconds duration, Login login) {
+    std::vector<std::thread> workers;
+    std::vector<size_t> counts(threads);
+    std::atomic<bool> failed{false};
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            unsigned seed = 12345u + static_cast<unsigned>(t);
+            size_t n = 0;
+            while (std::chrono::steady_clock::now() - start < duration) {
+                for (int i = 0; i < 64; ++i) {
+                    seed = seed * 1103515245u + 12345u;
+                    std::string id = std::to_string(1 + (seed >> 8) % users);
+                    if (!login("user" + id, "pass" + id)) failed = true;
+                }
+                n += 64;
+            }
+            counts[t] = n;
+        });
+    }
+    for (auto& w : workers) w.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (failed) std::printf("a login failed\n");
+
+    size_t total = 0;
+    for (size_t c : counts) total += c;
+    return static_cast<double>(total) / seconds;
+}
+
+int main(int argc, char** argv) {
+    size_t users = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    if (users == 0) users = 1;
+
+    sqlite3* shared = baseline::open_db(users);
+    UserDb db("file:login_throughput?mode=memory&cache=shared");
+    db.exec(schema_sql);
+    db.seed_users(users);
+    db.exec(index_sql);
+
+    const std::chrono::milliseconds duration(500);
+    std::printf("%zu users\n", users);
+    std::printf("%8s %18s %18s %9s\n", "threads", "shared logins/s", "cached logins/s", "speedup");
+    for (int threads = 1; threads <= 16; threads *= 2) {
+        double before = logins_per_sec(threads, users, duration,
+                                       [&](const std::string& u, const std::string& p) {
+                                           return baseline::login(shared, u, p);
+                                       });
+        double after = logins_per_sec(threads, users, duration,
+                                      [&](const std::string& u, const std::string& p) {
+                                          return login(db, u, p);
+                                      });
+        std::printf("%8d %18.0f %18.0f %8.2fx\n", threads, before, after, after / before);
+    }
+    sqlite3_close(shared);
+    return 0;
+}
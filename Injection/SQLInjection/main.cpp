@@ -1,31 +1,43 @@
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include <sqlite3.h>
 #include "httplib.h"
+#include "auth_service.h"
+#include "user_db.h"
 
-// Initialize SQLite DB and create a users table
-void init_db(sqlite3* &db) {
-    int rc = sqlite3_open(":memory:", &db); // in-memory DB
-    if (rc) {
-        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << "\n";
-        exit(1);
-    }
+// Create the users table in the (in-memory) DB.
+// SQLI_SEED_USERS=N additionally loads N generated users (user1/pass1, ...)
+// to see how logins behave on a large table.
+void init_db(UserDb& db) {
     const char* create_table_sql =
         "CREATE TABLE users (id INTEGER PRIMARY KEY, username TEXT, password TEXT);"
         "INSERT INTO users (username, password) VALUES ('alice', 'alicepass');"
         "INSERT INTO users (username, password) VALUES ('bob', 'bobpass');";
 
-    char* errmsg = nullptr;
-    rc = sqlite3_exec(db, create_table_sql, nullptr, nullptr, &errmsg);
-    if (rc != SQLITE_OK) {
-        std::cerr << "SQL error: " << errmsg << "\n";
-        sqlite3_free(errmsg);
+    try {
+        db.exec(create_table_sql);
+
+        if (const char* seed = std::getenv("SQLI_SEED_USERS")) {
+            size_t count = std::strtoull(seed, nullptr, 10);
+            auto start = std::chrono::steady_clock::now();
+            db.seed_users(count);
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            std::cout << "Seeded " << count << " users in " << ms << " ms\n";
+        }
+
+        // Built after seeding: one sorted build beats updating it per insert
+        db.exec("CREATE UNIQUE INDEX users_username ON users (username);");
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
         exit(1);
     }
 }
 
-// Simple HTML login form
-const char* login_page_html = R"(
+// Simple HTML login form, parsed once at startup
+const httplib::Template login_page(R"(
 <!DOCTYPE html>
 <html>
 <head>
@@ -91,52 +103,14 @@ const char* login_page_html = R"(
       <input name="password" type="password" placeholder="Password" required /><br/>
       <input type="submit" value="Login" />
     </form>
-    %ERROR_MSG%
+    {{{error}}}
   </div>
 </body>
 </html>
-)";
-
-
-int main() {
-    sqlite3* db = nullptr;
-    init_db(db);
-
-    httplib::Server svr;
-
-    // Serve login page at /
-    svr.Get("/", [&](const httplib::Request& req, httplib::Response& res) {
-        std::string page(login_page_html);
-        // no error initially
-        size_t pos = page.find("%ERROR_MSG%");
-        if (pos != std::string::npos) {
-            page.replace(pos, 11, "");
-        }
-        res.set_content(page, "text/html");
-    });
-
-    // Vulnerable login endpoint
-    svr.Post("/login", [&](const httplib::Request& req, httplib::Response& res) {
-        auto username = req.get_param_value("username");
-        auto password = req.get_param_value("password");
-
-        // Vulnerable SQL query
-        std::string query = "SELECT * FROM users WHERE username = '" + username +
-                            "' AND password = '" + password + "';";
-
-        sqlite3_stmt* stmt;
-        int rc = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr);
-        if (rc != SQLITE_OK) {
-            res.status = 500;
-            res.set_content("SQL error during prepare.", "text/plain");
-            return;
-        }
+)", {"error"});
 
-        rc = sqlite3_step(stmt);
-        if (rc == SQLITE_ROW) {
-            // User found — show welcome page
-            std::string user = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-            std::string welcome_page = R"(
+// Welcome page shown after a successful login
+const httplib::Template welcome_page(R"(
 <!DOCTYPE html>
 <html>
 <head>
@@ -171,29 +145,86 @@ int main() {
 </head>
 <body>
   <div class="welcome-box">
-    <h2>Welcome, )" + user + R"(!</h2>
+    <h2>Welcome, {{user}}!</h2>
     <p>Login successful.</p>
   </div>
 </body>
 </html>
-)";
+)", {"user"});
+
+int main() {
+    std::unique_ptr<UserDb> db;
+    try {
+        db.reset(new UserDb());
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    init_db(*db);
+
+    httplib::Server svr;
+
+    // Serve login page at /
+    svr.Get("/", [&](const httplib::Request& req, httplib::Response& res) {
+        // no error initially
+        res.set_content(login_page.render({""}), "text/html");
+    });
+
+    // Identical concurrent logins run one query; at most 8 queries at once
+    // and 8 more waiting. Running and waiting logins each hold a worker
+    // thread, so together they may take at most half the pool.
+    constexpr size_t pool_size = 32;
+    constexpr size_t login_slots = 8;
+    svr.new_task_queue = [] { return new httplib::ThreadPool(pool_size); };
+    httplib::RequestCoalescer login_coalescer;
+    httplib::ConcurrencyLimiter login_limiter(login_slots, pool_size / 2 - login_slots);
+
+    // Vulnerable login endpoint
+    svr.Post("/login", login_coalescer.wrap(login_limiter.wrap([&](const httplib::Request& req, httplib::Response& res) {
+        auto username = req.get_param_value("username");
+        auto password = req.get_param_value("password");
+
+        // Vulnerable SQL query
+        std::string query = "SELECT * FROM users WHERE username = '" + username +
+                            "' AND password = '" + password + "';";
 
-            res.set_content(welcome_page, "text/html");
+        sqlite3_stmt* stmt;
+        int rc = sqlite3_prepare_v2(db->connection().handle(), query.c_str(), -1, &stmt, nullptr);
+        if (rc != SQLITE_OK) {
+            res.status = 500;
+            res.set_content("SQL error during prepare.", "text/plain");
+            return;
+        }
+
+        rc = sqlite3_step(stmt);
+        if (rc == SQLITE_ROW) {
+            // User found — show welcome page
+            std::string user = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            res.set_content(welcome_page.render({user}), "text/html");
         } else {
             // Login failed — show login page with error message
-            std::string page(login_page_html);
-size_t pos = page.find("%ERROR_MSG%");
-if (pos != std::string::npos) {
-    page.replace(pos, 11, "<div class='error'>Invalid username or password</div>");
-}
-res.set_content(page, "text/html");
+            res.set_content(login_page.render({"<div class='error'>Invalid username or password</div>"}), "text/html");
         }
         sqlite3_finalize(stmt);
+    })));
+
+    // Login with a parameterized query (safe). Concurrent logins are checked
+    // together in one batched query on the auth service's DB thread.
+    AuthService auth(*db);
+    svr.Post("/login2", [&](const httplib::Request& req, httplib::Response& res) {
+        auto username = req.get_param_value("username");
+        auto password = req.get_param_value("password");
+
+        AuthResult result = auth.submit(username, password).get();
+        if (result.ok) {
+            res.set_content(welcome_page.render({result.username}), "text/html");
+        } else {
+            res.set_content(login_page.render({"<div class='error'>Invalid username or password</div>"}), "text/html");
+        }
     });
 
     std::cout << "Server started at http://localhost:8080\n";
     svr.listen("0.0.0.0", 8080);
 
-    sqlite3_close(db);
     return 0;
 }
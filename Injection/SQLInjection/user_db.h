@@ -0,0 +1,159 @@
+#ifndef USER_DB_H
+#define USER_DB_H
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <sqlite3.h>
+
+// One SQLite connection plus the prepared statements compiled on it.
+// A connection is only ever used by the thread that opened it.
+class DbConnection {
+public:
+    explicit DbConnection(const std::string& uri) {
+        int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_URI |
+                    SQLITE_OPEN_NOMUTEX;
+        if (sqlite3_open_v2(uri.c_str(), &db_, flags, nullptr) != SQLITE_OK) {
+            std::string msg = db_ ? sqlite3_errmsg(db_) : "out of memory";
+            sqlite3_close(db_);
+            throw std::runtime_error("Can't open database: " + msg);
+        }
+        sqlite3_busy_timeout(db_, 5000);
+    }
+
+    ~DbConnection() {
+        for (auto& kv : statements_) sqlite3_finalize(kv.second);
+        sqlite3_close(db_);
+    }
+
+    DbConnection(const DbConnection&) = delete;
+    DbConnection& operator=(const DbConnection&) = delete;
+
+    sqlite3* handle() const { return db_; }
+
+    // Prepared statement for `sql`, compiled on first use and reused after.
+    // Returns nullptr if the SQL does not compile.
+    sqlite3_stmt* prepare_cached(const std::string& sql) {
+        auto it = statements_.find(sql);
+        if (it != statements_.end()) return it->second;
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v3(db_, sql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &stmt,
+                               nullptr) != SQLITE_OK) {
+            return nullptr;
+        }
+        statements_.emplace(sql, stmt);
+        return stmt;
+    }
+
+private:
+    sqlite3* db_ = nullptr;
+    std::unordered_map<std::string, sqlite3_stmt*> statements_;
+};
+
+// A cached statement checked out for one query. Bindings and the cursor are
+// reset when it goes out of scope, ready for the next caller on this thread.
+class CachedStatement {
+public:
+    explicit CachedStatement(sqlite3_stmt* stmt) : stmt_(stmt) {}
+    ~CachedStatement() {
+        if (stmt_) {
+            sqlite3_reset(stmt_);
+            sqlite3_clear_bindings(stmt_);
+        }
+    }
+
+    CachedStatement(const CachedStatement&) = delete;
+    CachedStatement& operator=(const CachedStatement&) = delete;
+
+    explicit operator bool() const { return stmt_ != nullptr; }
+    sqlite3_stmt* get() const { return stmt_; }
+
+    void bind(int index, const std::string& value) {
+        sqlite3_bind_text(stmt_, index, value.data(), static_cast<int>(value.size()),
+                          SQLITE_TRANSIENT);
+    }
+
+    int step() { return sqlite3_step(stmt_); }
+
+    std::string column_text(int index) const {
+        const unsigned char* text = sqlite3_column_text(stmt_, index);
+        return text ? reinterpret_cast<const char*>(text) : "";
+    }
+
+private:
+    sqlite3_stmt* stmt_;
+};
+
+// Users database shared by all server worker threads.
+// Each thread gets its own connection to one shared-cache in-memory database,
+// so workers never serialize on a single sqlite3* handle. The database object
+// keeps one connection of its own open, which keeps the in-memory data alive.
+class UserDb {
+public:
+    explicit UserDb(std::string uri = "file:users?mode=memory&cache=shared")
+        : uri_(std::move(uri)), owner_(uri_) {}
+
+    UserDb(const UserDb&) = delete;
+    UserDb& operator=(const UserDb&) = delete;
+
+    // Run a script on the owning connection (schema setup, seeding)
+    void exec(const char* sql) {
+        char* errmsg = nullptr;
+        if (sqlite3_exec(owner_.handle(), sql, nullptr, nullptr, &errmsg) != SQLITE_OK) {
+            std::string msg = errmsg ? errmsg : "unknown error";
+            sqlite3_free(errmsg);
+            throw std::runtime_error("SQL error: " + msg);
+        }
+    }
+
+    // Insert `count` generated users (user1/pass1, user2/pass2, ...) in a
+    // single transaction through one prepared statement
+    void seed_users(size_t count) {
+        exec("BEGIN;");
+        sqlite3_stmt* stmt = owner_.prepare_cached(
+            "INSERT INTO users (username, password) VALUES (?1, ?2);");
+        if (!stmt) {
+            exec("ROLLBACK;");
+            throw std::runtime_error(std::string("SQL error: ") +
+                                     sqlite3_errmsg(owner_.handle()));
+        }
+        for (size_t i = 1; i <= count; ++i) {
+            std::string n = std::to_string(i);
+            std::string username = "user" + n;
+            std::string password = "pass" + n;
+            sqlite3_bind_text(stmt, 1, username.data(), static_cast<int>(username.size()),
+                              SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 2, password.data(), static_cast<int>(password.size()),
+                              SQLITE_STATIC);
+            int rc = sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+            if (rc != SQLITE_DONE) {
+                std::string msg = sqlite3_errmsg(owner_.handle());
+                exec("ROLLBACK;");
+                throw std::runtime_error("SQL error: " + msg);
+            }
+        }
+        sqlite3_clear_bindings(stmt);
+        exec("COMMIT;");
+    }
+
+    // Connection for the calling thread, opened on first use and closed when
+    // the thread exits
+    DbConnection& connection() {
+        thread_local std::unordered_map<const UserDb*, std::unique_ptr<DbConnection>> conns;
+        auto& conn = conns[this];
+        if (!conn) conn.reset(new DbConnection(uri_));
+        return *conn;
+    }
+
+    CachedStatement statement(const std::string& sql) {
+        return CachedStatement(connection().prepare_cached(sql));
+    }
+
+private:
+    std::string uri_;
+    DbConnection owner_;
+};
+
+#endif // USER_DB_H
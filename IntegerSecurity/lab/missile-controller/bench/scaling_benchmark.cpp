@@ -0,0 +1,103 @@
+// Measures how target evaluation scales with the number of engage threads.
+//
+//   ./bin/scaling_benchmark [targets] [max_threads]
+//
+// Defaults: 4M targets, up to std::thread::hardware_concurrency() threads.
+
+#include "MissileController.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+    bool sameStatus(const TargetStatus& a, const TargetStatus& b) {
+        return a.statusCodes == b.statusCodes && a.finalDistances == b.finalDistances &&
+               a.flags == b.flags;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{1} << 22;
+    unsigned int maxThreads = argc > 2 ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10))
+                                       : std::max(1u, std::thread::hardware_concurrency());
+    const int rounds = 10;
+
+    // Deterministic mix: mostly in-range targets, plus boundary values,
+    // values just outside them and extremes for distance and priority
+    static const unsigned int distances[] = {1000u, 6000u, 999u, 6001u, 0u, UINT_MAX};
+    static const signed int priorities[] = {0, 10, -1, 11, INT_MIN, INT_MAX};
+    std::vector<Target> candidates(count);
+    unsigned int seed = 12345;
+    for (std::size_t i = 0; i < count; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned int distance = 1000u + (seed >> 4) % 5001u;
+        signed int priority = static_cast<signed int>((seed >> 20) % 11u);
+        unsigned int pick = (seed >> 28) % 6u;
+        switch ((seed >> 24) & 7u) {
+        case 0: distance = distances[pick]; break;
+        case 1: priority = priorities[pick]; break;
+        case 2:
+            distance = distances[pick];
+            priority = priorities[(seed >> 8) % 6u];
+            break;
+        default: break;  // in range
+        }
+        candidates[i] = Target{static_cast<int>(i), distance, priority};
+    }
+
+    MissileController controller;
+    IngestResult ingest = controller.addTargets(candidates.data(), candidates.size());
+
+    // addTargets rejects negative priorities, but addTarget still accepts
+    // them (its priority check never fails), so those with an in-range
+    // distance go in that way to exercise the clamped status codes
+    std::size_t legacy = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const Target& t = candidates[i];
+        if (ingest.isRejected(i) && t.priorityLevel < 0 && t.distanceMeters >= 1000u &&
+            t.distanceMeters <= 6000u) {
+            legacy += controller.addTarget(t.id, t.distanceMeters, t.priorityLevel);
+        }
+    }
+    std::size_t evaluated = ingest.accepted + legacy;
+    std::cout << "Candidates: " << count << ", accepted: " << ingest.accepted
+              << ", rejected: " << count - ingest.accepted << " (" << legacy
+              << " with negative priority added through addTarget)\n";
+    std::cout << "Targets: " << evaluated << ", rounds: " << rounds << "\n";
+    std::cout << "threads   ms/round   Mtargets/s   speedup\n";
+
+    TargetStatus baseline;
+    double baseMs = 0;
+    for (unsigned int threads = 1; threads <= maxThreads; ++threads) {
+        controller.setEngageThreads(threads);
+
+        TargetStatus status;
+        controller.evaluateTargets(status);  // warm-up: fault in the output pages
+
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r) controller.evaluateTargets(status);
+        double ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start).count() / rounds;
+
+        if (threads == 1) {
+            baseline = status;
+            baseMs = ms;
+        } else if (!sameStatus(status, baseline)) {
+            std::cerr << "Results with " << threads << " threads differ from 1 thread\n";
+            return 1;
+        }
+
+        std::cout << std::setw(7) << threads << std::fixed << std::setprecision(2)
+                  << std::setw(11) << ms << std::setw(13)
+                  << static_cast<double>(evaluated) / ms / 1000.0 << std::setw(10)
+                  << baseMs / ms << "\n";
+    }
+    return 0;
+}
@@ -1,13 +1,25 @@
 #ifndef MISSILE_CONTROLLER_H
 #define MISSILE_CONTROLLER_H
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
 
-struct Target {
-    int id;
-    unsigned int distanceMeters;  // Distance to target
-    signed int priorityLevel;     // Signed priority (-ve means no engagement)
+#include "StatusReporter.h"
+#include "TargetStore.h"
+#include "ThreadPool.h"
+
+// Outcome of a bulk addTargets call: bit i of `rejected` is set when
+// candidate i failed validation.
+struct IngestResult {
+    std::size_t accepted = 0;
+    std::vector<std::uint64_t> rejected;
+
+    bool isRejected(std::size_t index) const {
+        return (rejected[index / 64] >> (index % 64)) & 1u;
+    }
 };
 
 class MissileController {
@@ -16,13 +28,28 @@ public:
     ~MissileController();
 
     bool addTarget(int id, unsigned int distance, signed int priority);
+    IngestResult addTargets(const Target* candidates, std::size_t count);
     void engageTargets();
+
+    // Like engageTargets(), but with the saturating column kernel
+    // (evaluateTargets) instead of the wrap-around arithmetic
+    void engageTargetsChecked();
     void allocateWarheadBuffer(unsigned int warheadCount);
+    void setReportFormat(ReportFormat format);
+
+    // Evaluate targets on `threads` cores in engageTargetsChecked()
+    // (1 = serial, the default)
+    void setEngageThreads(unsigned int threads);
+
+    // Status codes and adjusted distances for all targets, in target order
+    void evaluateTargets(TargetStatus& status);
 
 private:
-    std::vector<Target> targets;
+    TargetStore targets;
     char* warheadBuffer;
     unsigned int warheadBufferSize;
+    StatusReporter reporter;  // one writer thread for every engagement
+    std::unique_ptr<ThreadPool> pool;
 
     void processTargets();
 };
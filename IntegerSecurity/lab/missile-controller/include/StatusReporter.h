@@ -0,0 +1,79 @@
+#ifndef STATUS_REPORTER_H
+#define STATUS_REPORTER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TargetStore.h"
+
+// One fixed-size status line for a target
+struct StatusRecord {
+    int id;
+    unsigned int statusCode;
+    unsigned short finalDistance;
+    std::uint8_t flags;  // TargetFlag bits
+};
+
+enum class ReportFormat {
+    Text,  // the controller's human-readable lines
+    Csv,   // header row, then id,status_code,final_distance,flags
+    Json,  // one JSON object per line
+};
+
+// Collects status records in memory and writes them out in bulk.
+//
+// record() only appends to a buffer. When `batchSize` records have
+// accumulated, the buffer is handed to a writer thread that formats it and
+// writes the whole batch with one write and one flush, while the caller
+// keeps filling a second buffer. Anything left is written by flush() or
+// the destructor. One reporter (and its thread) is meant to serve any
+// number of reports.
+class StatusReporter {
+public:
+    explicit StatusReporter(std::ostream& out, ReportFormat format = ReportFormat::Text,
+                            std::size_t batchSize = 1 << 16);
+    ~StatusReporter();
+
+    StatusReporter(const StatusReporter&) = delete;
+    StatusReporter& operator=(const StatusReporter&) = delete;
+
+    void record(const StatusRecord& rec) {
+        current_.push_back(rec);
+        if (current_.size() >= batchSize_) submit();
+    }
+
+    // Write everything recorded so far and wait until it is out
+    void flush();
+
+    // Flush, then use `format` for later records (a CSV report starts
+    // with a new header row)
+    void setFormat(ReportFormat format);
+
+private:
+    void submit();
+    void run();
+    void format(const std::vector<StatusRecord>& records, std::string& text);
+
+    std::ostream& out_;
+    ReportFormat format_;
+    std::size_t batchSize_;
+    bool headerWritten_ = false;  // writer thread, or setFormat() while it is idle
+
+    std::vector<StatusRecord> current_;  // filled by record()
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<StatusRecord> pending_;  // full batch waiting for the writer
+    bool hasPending_ = false;
+    bool writing_ = false;
+    bool stop_ = false;
+    std::thread writer_;
+};
+
+#endif // STATUS_REPORTER_H
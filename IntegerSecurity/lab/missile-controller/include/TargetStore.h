@@ -0,0 +1,108 @@
+#ifndef TARGET_STORE_H
+#define TARGET_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+struct Target {
+    int id;
+    unsigned int distanceMeters;  // Distance to target
+    signed int priorityLevel;     // Signed priority (-ve means no engagement)
+};
+
+// Allocator that starts every array on a cache line, so SIMD loads over a
+// column never straddle two lines at the start.
+template <typename T>
+struct AlignedAllocator {
+    using value_type = T;
+    static constexpr std::size_t alignment = 64;
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment)));
+    }
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U>&) const { return false; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+// Per-target flags set by TargetStore::evaluate where the lab's scalar
+// code silently converts, truncates or wraps
+enum TargetFlag : std::uint8_t {
+    kNegativePriority = 1,   // status code clamped to 0
+    kDistanceTruncated = 2,  // distance above 65535, clamped to 65535
+    kDistanceSaturated = 4,  // distance + 65000 saturated at 65535
+    kWrapAround = 8,         // computed by the unchecked lab code, may have wrapped
+};
+
+// Results of TargetStore::evaluate, one entry per target in store order
+struct TargetStatus {
+    AlignedVector<unsigned int> statusCodes;
+    AlignedVector<unsigned short> finalDistances;
+    AlignedVector<std::uint8_t> flags;
+
+    void resize(std::size_t n) {
+        statusCodes.resize(n);
+        finalDistances.resize(n);
+        flags.resize(n);
+    }
+};
+
+// Targets stored as separate id / distance / priority columns
+// (structure of arrays), so the per-target arithmetic runs over contiguous
+// values of one type.
+class TargetStore {
+public:
+    std::size_t size() const { return ids_.size(); }
+    bool empty() const { return ids_.empty(); }
+
+    void reserve(std::size_t n) {
+        ids_.reserve(n);
+        distances_.reserve(n);
+        priorities_.reserve(n);
+    }
+
+    void push_back(const Target& target) {
+        ids_.push_back(target.id);
+        distances_.push_back(target.distanceMeters);
+        priorities_.push_back(target.priorityLevel);
+    }
+
+    void clear() {
+        ids_.clear();
+        distances_.clear();
+        priorities_.clear();
+    }
+
+    const int* ids() const { return ids_.data(); }
+    const unsigned int* distances() const { return distances_.data(); }
+    const signed int* priorities() const { return priorities_.data(); }
+
+    // Compute status codes and adjusted distances for every target, with
+    // saturating arithmetic instead of wrap-around; `out` is resized to size().
+    void evaluate(TargetStatus& out) const;
+
+    // Same for targets [begin, end) only; `out` must already hold size()
+    // entries. Disjoint ranges may be evaluated concurrently.
+    void evaluate(std::size_t begin, std::size_t end, TargetStatus& out) const;
+
+private:
+    AlignedVector<int> ids_;
+    AlignedVector<unsigned int> distances_;
+    AlignedVector<signed int> priorities_;
+};
+
+#endif // TARGET_STORE_H
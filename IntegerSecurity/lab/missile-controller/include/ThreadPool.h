@@ -0,0 +1,45 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops. The thread calling
+// parallelFor works alongside them, so a pool of size N starts N - 1
+// threads.
+class ThreadPool {
+public:
+    explicit ThreadPool(std::size_t threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t size() const { return workers_.size() + 1; }
+
+    // Call fn(i) for every i in [0, count). Indexes are handed out one at a
+    // time to whichever thread is free; returns when all calls have finished.
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn);
+
+private:
+    void run();
+
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable startCv_;
+    std::condition_variable doneCv_;
+    const std::function<void(std::size_t)>* job_ = nullptr;
+    std::size_t jobCount_ = 0;
+    std::size_t generation_ = 0;  // bumped for every parallelFor
+    std::size_t busy_ = 0;        // workers still in the current job
+    bool stop_ = false;
+    std::atomic<std::size_t> next_{0};
+};
+
+#endif // THREAD_POOL_H
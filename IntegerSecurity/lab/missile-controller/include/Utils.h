@@ -7,6 +7,13 @@ namespace Utils {
     unsigned int calculateWarheadMemory(unsigned int count);
     unsigned int priorityToCode(signed int priorityLevel);
     unsigned short adjustDistance(unsigned int distanceMeters);
+
+    // a - b into `result`; returns false if it wrapped below zero. Defined
+    // here so it inlines into vectorized validation loops.
+    inline bool checkedSub(unsigned int a, unsigned int b, unsigned int& result) {
+        result = a - b;
+        return a >= b;
+    }
 }
 
 #endif // UTILS_H
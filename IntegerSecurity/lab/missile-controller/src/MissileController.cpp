@@ -1,11 +1,24 @@
 #include "MissileController.h"
 #include "Utils.h"
 
+#include <algorithm>
+#include <bitset>
 #include <iostream>
 #include <cstring>
 
+namespace {
+    constexpr unsigned int kMinRangeMeters = 1000;
+    constexpr unsigned int kMaxRangeSpanMeters = 5000;  // beyond kMinRangeMeters
+    constexpr signed int kMaxPriority = 10;
+
+    // Targets per parallel work item: about 120 KB of input and output
+    // columns, small enough to stay in L2. A multiple of 64, so neighbouring
+    // chunks never write to the same cache line of any output column.
+    constexpr std::size_t kChunkTargets = 8192;
+}
+
 MissileController::MissileController()
-    : warheadBuffer(nullptr), warheadBufferSize(0) {}
+    : warheadBuffer(nullptr), warheadBufferSize(0), reporter(std::cout) {}
 
 MissileController::~MissileController() {
     if (warheadBuffer) {
@@ -31,6 +44,42 @@ bool MissileController::addTarget(int id, unsigned int distance, signed int prio
     return true;
 }
 
+IngestResult MissileController::addTargets(const Target* candidates, std::size_t count) {
+    IngestResult result;
+    result.rejected.assign((count + 63) / 64, 0);
+
+    // Pass 1: validate 64 candidates per bitmap word. The checks are plain
+    // comparisons with no branches or output, so the loop vectorizes; the
+    // flags are then packed into the word.
+    std::size_t rejectedCount = 0;
+    unsigned char bad[64];
+    for (std::size_t base = 0; base < count; base += 64) {
+        std::size_t n = std::min<std::size_t>(64, count - base);
+        for (std::size_t j = 0; j < n; ++j) {
+            const Target& t = candidates[base + j];
+            unsigned int span;
+            bool ok = Utils::checkedSub(t.distanceMeters, kMinRangeMeters, span) &
+                      (span <= kMaxRangeSpanMeters) &
+                      (t.priorityLevel >= 0) & (t.priorityLevel <= kMaxPriority);
+            bad[j] = !ok;
+        }
+        std::uint64_t bits = 0;
+        for (std::size_t j = 0; j < n; ++j) {
+            bits |= static_cast<std::uint64_t>(bad[j]) << j;
+        }
+        result.rejected[base / 64] = bits;
+        rejectedCount += std::bitset<64>(bits).count();
+    }
+
+    // Pass 2: append the accepted ones after a single reservation
+    result.accepted = count - rejectedCount;
+    targets.reserve(targets.size() + result.accepted);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!result.isRejected(i)) targets.push_back(candidates[i]);
+    }
+    return result;
+}
+
 void MissileController::allocateWarheadBuffer(unsigned int warheadCount) {
     // Vulnerability 3: Integer overflow in memory allocation size
     warheadBufferSize = Utils::calculateWarheadMemory(warheadCount);
@@ -40,21 +89,68 @@ void MissileController::allocateWarheadBuffer(unsigned int warheadCount) {
     std::memset(warheadBuffer, 0, warheadBufferSize);
 }
 
+void MissileController::setReportFormat(ReportFormat format) {
+    reporter.setFormat(format);
+}
+
+void MissileController::setEngageThreads(unsigned int threads) {
+    if (threads > 1) {
+        pool.reset(new ThreadPool(threads));
+    } else {
+        pool.reset();
+    }
+}
+
 void MissileController::engageTargets() {
     processTargets();
 }
 
+void MissileController::evaluateTargets(TargetStatus& status) {
+    if (!pool) {
+        targets.evaluate(status);
+        return;
+    }
+
+    // Each chunk writes only its own slice of `status`, so the merged
+    // result is in target order no matter which thread ran which chunk
+    status.resize(targets.size());
+    std::size_t chunks = (targets.size() + kChunkTargets - 1) / kChunkTargets;
+    pool->parallelFor(chunks, [&](std::size_t chunk) {
+        std::size_t begin = chunk * kChunkTargets;
+        targets.evaluate(begin, std::min(begin + kChunkTargets, targets.size()), status);
+    });
+}
+
+void MissileController::engageTargetsChecked() {
+    // Status codes and distances for all targets; conversions that wrap in
+    // processTargets() are saturated and flagged
+    TargetStatus status;
+    evaluateTargets(status);
+
+    // Records are formatted and written in batches on the reporter's thread;
+    // the report is complete when this returns
+    const int* ids = targets.ids();
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        reporter.record(StatusRecord{ids[i], status.statusCodes[i], status.finalDistances[i],
+                                     status.flags[i]});
+    }
+    reporter.flush();
+}
+
 void MissileController::processTargets() {
-    for (const auto& target : targets) {
+    const int* ids = targets.ids();
+    const unsigned int* distances = targets.distances();
+    const signed int* priorities = targets.priorities();
+    for (std::size_t i = 0; i < targets.size(); ++i) {
         // Vulnerability 4: Signed to unsigned conversion causing large value
-        unsigned int statusCode = Utils::priorityToCode(target.priorityLevel);
-        std::cout << "Target " << target.id << " status code: " << statusCode << std::endl;
+        unsigned int statusCode = Utils::priorityToCode(priorities[i]);
 
         // Vulnerability 5: Truncation on distance conversion
-        unsigned short dist = Utils::adjustDistance(target.distanceMeters);
+        unsigned short dist = Utils::adjustDistance(distances[i]);
 
         // Vulnerability 6: Wrap-around on distance arithmetic
         unsigned short finalDist = dist + 65000;  // 16-bit wrap-around
-        std::cout << "Final Distance (wrap-around): " << finalDist << std::endl;
+        reporter.record(StatusRecord{ids[i], statusCode, finalDist, kWrapAround});
     }
+    reporter.flush();
 }
@@ -0,0 +1,130 @@
+#include "StatusReporter.h"
+
+#include <charconv>
+
+namespace {
+    template <typename T>
+    void appendNumber(std::string& text, T value) {
+        char buf[24];
+        auto res = std::to_chars(buf, buf + sizeof(buf), value);
+        text.append(buf, res.ptr);
+    }
+}
+
+StatusReporter::StatusReporter(std::ostream& out, ReportFormat format, std::size_t batchSize)
+    : out_(out), format_(format), batchSize_(batchSize ? batchSize : 1) {
+    current_.reserve(batchSize_);
+    writer_ = std::thread([this] { run(); });
+}
+
+StatusReporter::~StatusReporter() {
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    writer_.join();
+}
+
+void StatusReporter::flush() {
+    if (!current_.empty()) submit();
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !hasPending_ && !writing_; });
+}
+
+void StatusReporter::setFormat(ReportFormat format) {
+    // After flush() the writer is idle until the next submit(), which
+    // hands over these changes under the mutex
+    flush();
+    format_ = format;
+    headerWritten_ = false;
+}
+
+void StatusReporter::submit() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // At most one batch queued behind the one being written
+    cv_.wait(lock, [this] { return !hasPending_; });
+    current_.swap(pending_);
+    hasPending_ = true;
+    lock.unlock();
+    cv_.notify_all();
+
+    current_.clear();
+    current_.reserve(batchSize_);
+}
+
+void StatusReporter::run() {
+    std::vector<StatusRecord> batch;
+    std::string text;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this] { return stop_ || hasPending_; });
+        if (!hasPending_) return;  // stopping with nothing left to write
+
+        batch.swap(pending_);
+        hasPending_ = false;
+        writing_ = true;
+        lock.unlock();
+        cv_.notify_all();
+
+        text.clear();
+        format(batch, text);
+        out_.write(text.data(), static_cast<std::streamsize>(text.size()));
+        out_.flush();
+        batch.clear();
+
+        lock.lock();
+        writing_ = false;
+        cv_.notify_all();
+    }
+}
+
+void StatusReporter::format(const std::vector<StatusRecord>& records, std::string& text) {
+    text.reserve(records.size() * 80);
+
+    if (format_ == ReportFormat::Csv && !headerWritten_) {
+        text += "id,status_code,final_distance,flags\n";
+        headerWritten_ = true;
+    }
+
+    for (const StatusRecord& r : records) {
+        switch (format_) {
+        case ReportFormat::Text:
+            text += "Target ";
+            appendNumber(text, r.id);
+            text += " status code: ";
+            appendNumber(text, r.statusCode);
+            if (r.flags & kNegativePriority) text += " (negative priority)";
+            // The lab code's own wording for its unchecked results
+            text += r.flags & kWrapAround ? "\nFinal Distance (wrap-around): "
+                                          : "\nFinal Distance: ";
+            appendNumber(text, r.finalDistance);
+            if (r.flags & kDistanceTruncated) text += " (truncated)";
+            if (r.flags & kDistanceSaturated) text += " (saturated)";
+            text += '\n';
+            break;
+        case ReportFormat::Csv:
+            appendNumber(text, r.id);
+            text += ',';
+            appendNumber(text, r.statusCode);
+            text += ',';
+            appendNumber(text, r.finalDistance);
+            text += ',';
+            appendNumber(text, static_cast<unsigned int>(r.flags));
+            text += '\n';
+            break;
+        case ReportFormat::Json:
+            text += "{\"id\":";
+            appendNumber(text, r.id);
+            text += ",\"status_code\":";
+            appendNumber(text, r.statusCode);
+            text += ",\"final_distance\":";
+            appendNumber(text, r.finalDistance);
+            text += ",\"flags\":";
+            appendNumber(text, static_cast<unsigned int>(r.flags));
+            text += "}\n";
+            break;
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#include "TargetStore.h"
+
+#include <climits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+    constexpr unsigned int kMaxDistance16 = 0xFFFF;
+    constexpr unsigned int kDistanceOffset = 65000;
+
+    void evaluateScalar(const unsigned int* distances, const signed int* priorities,
+                        std::size_t begin, std::size_t end, TargetStatus& out) {
+        for (std::size_t i = begin; i < end; ++i) {
+            std::uint8_t flags = 0;
+
+            signed int priority = priorities[i];
+            if (priority < 0) flags |= kNegativePriority;
+            out.statusCodes[i] = priority < 0 ? 0u : static_cast<unsigned int>(priority);
+
+            unsigned int dist = distances[i];
+            if (dist > kMaxDistance16) {
+                flags |= kDistanceTruncated;
+                dist = kMaxDistance16;
+            }
+            unsigned int finalDist = dist + kDistanceOffset;
+            if (finalDist > kMaxDistance16) {
+                flags |= kDistanceSaturated;
+                finalDist = kMaxDistance16;
+            }
+            out.finalDistances[i] = static_cast<unsigned short>(finalDist);
+            out.flags[i] = flags;
+        }
+    }
+
+#if defined(__SSE2__)
+    // Eight targets per iteration, using SSE2 only (the x86-64 baseline)
+    std::size_t evaluateSse2(const unsigned int* distances, const signed int* priorities,
+                             std::size_t begin, std::size_t end, TargetStatus& out) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i signBit32 = _mm_set1_epi32(INT_MIN);
+        const __m128i limitBiased = _mm_set1_epi32(INT_MIN + static_cast<int>(kMaxDistance16));
+        const __m128i max16 = _mm_set1_epi32(static_cast<int>(kMaxDistance16));
+        const __m128i half16 = _mm_set1_epi32(0x8000);
+        const __m128i signBit16 = _mm_set1_epi16(SHRT_MIN);
+        const __m128i offset = _mm_set1_epi16(static_cast<short>(kDistanceOffset - 0x10000));
+        const __m128i negFlag = _mm_set1_epi16(kNegativePriority);
+        const __m128i truncFlag = _mm_set1_epi16(kDistanceTruncated);
+        const __m128i satFlag = _mm_set1_epi16(kDistanceSaturated);
+
+        std::size_t i = begin;
+        for (; i + 8 <= end; i += 8) {
+            // Status codes: negative priorities clamp to 0
+            __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(priorities + i));
+            __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(priorities + i + 4));
+            __m128i neg0 = _mm_srai_epi32(p0, 31);
+            __m128i neg1 = _mm_srai_epi32(p1, 31);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out.statusCodes.data() + i),
+                             _mm_andnot_si128(neg0, p0));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out.statusCodes.data() + i + 4),
+                             _mm_andnot_si128(neg1, p1));
+
+            // Clamp distances to 16 bits (unsigned compare via the sign-bias trick)
+            __m128i d0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(distances + i));
+            __m128i d1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(distances + i + 4));
+            __m128i big0 = _mm_cmpgt_epi32(_mm_xor_si128(d0, signBit32), limitBiased);
+            __m128i big1 = _mm_cmpgt_epi32(_mm_xor_si128(d1, signBit32), limitBiased);
+            d0 = _mm_or_si128(_mm_andnot_si128(big0, d0), _mm_and_si128(big0, max16));
+            d1 = _mm_or_si128(_mm_andnot_si128(big1, d1), _mm_and_si128(big1, max16));
+
+            // Narrow to eight u16 lanes: shift into signed range so packs is exact
+            __m128i dist = _mm_xor_si128(
+                _mm_packs_epi32(_mm_sub_epi32(d0, half16), _mm_sub_epi32(d1, half16)), signBit16);
+
+            // Saturating add; lanes that differ from the wrapping add overflowed
+            __m128i finalDist = _mm_adds_epu16(dist, offset);
+            __m128i saturated = _mm_xor_si128(
+                _mm_cmpeq_epi16(finalDist, _mm_add_epi16(dist, offset)), _mm_cmpeq_epi16(zero, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out.finalDistances.data() + i), finalDist);
+
+            __m128i flags = _mm_or_si128(
+                _mm_or_si128(_mm_and_si128(_mm_packs_epi32(neg0, neg1), negFlag),
+                             _mm_and_si128(_mm_packs_epi32(big0, big1), truncFlag)),
+                _mm_and_si128(saturated, satFlag));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out.flags.data() + i),
+                             _mm_packus_epi16(flags, zero));
+        }
+        return i;
+    }
+#endif
+}
+
+void TargetStore::evaluate(TargetStatus& out) const {
+    out.resize(size());
+    evaluate(0, size(), out);
+}
+
+void TargetStore::evaluate(std::size_t begin, std::size_t end, TargetStatus& out) const {
+    std::size_t done = begin;
+#if defined(__SSE2__)
+    done = evaluateSse2(distances_.data(), priorities_.data(), begin, end, out);
+#endif
+    evaluateScalar(distances_.data(), priorities_.data(), done, end, out);
+}
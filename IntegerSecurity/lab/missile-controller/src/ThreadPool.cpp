@@ -0,0 +1,57 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(std::size_t threads) {
+    for (std::size_t i = 1; i < threads; ++i) {
+        workers_.emplace_back([this] { run(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    startCv_.notify_all();
+    for (std::thread& t : workers_) t.join();
+}
+
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn) {
+    if (workers_.empty() || count <= 1) {
+        for (std::size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &fn;
+        jobCount_ = count;
+        next_ = 0;
+        busy_ = workers_.size();
+        ++generation_;
+    }
+    startCv_.notify_all();
+
+    for (std::size_t i; (i = next_.fetch_add(1)) < count;) fn(i);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCv_.wait(lock, [this] { return busy_ == 0; });
+    job_ = nullptr;
+}
+
+void ThreadPool::run() {
+    std::size_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        startCv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_) return;
+        seen = generation_;
+        const std::function<void(std::size_t)>& fn = *job_;
+        std::size_t count = jobCount_;
+        lock.unlock();
+
+        for (std::size_t i; (i = next_.fetch_add(1)) < count;) fn(i);
+
+        lock.lock();
+        if (--busy_ == 0) doneCv_.notify_all();
+    }
+}
@@ -1,10 +1,29 @@
 #include "MissileController.h"
 #include <iostream>
 #include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 
 int main() {
     MissileController controller;
 
+    // MISSILE_REPORT=csv or json switches the engagement report format
+    if (const char* report = std::getenv("MISSILE_REPORT")) {
+        if (std::strcmp(report, "csv") == 0) controller.setReportFormat(ReportFormat::Csv);
+        if (std::strcmp(report, "json") == 0) controller.setReportFormat(ReportFormat::Json);
+    }
+
+    // MISSILE_ENGAGE=checked engages with saturating arithmetic instead of
+    // the wrap-around code below
+    const char* engage = std::getenv("MISSILE_ENGAGE");
+    bool checked = engage && std::strcmp(engage, "checked") == 0;
+
+    // MISSILE_THREADS=N evaluates targets on N threads (checked engagement)
+    if (const char* threads = std::getenv("MISSILE_THREADS")) {
+        controller.setEngageThreads(static_cast<unsigned int>(std::strtoul(threads, nullptr, 10)));
+    }
+
     // Add targets with edge values to trigger vulnerabilities
 
     // Underflow: distance < 1000 triggers underflow
@@ -16,11 +35,24 @@ int main() {
     // Normal target
     controller.addTarget(3, 3000, 7);
 
+    // Bulk ingestion validates with checked arithmetic, so these two
+    // edge cases are rejected instead of slipping through
+    std::vector<Target> batch = {{4, 800, 5}, {5, 1500, -5}, {6, 4500, 2}};
+    IngestResult ingest = controller.addTargets(batch.data(), batch.size());
+    std::cout << "Batch: " << ingest.accepted << " of " << batch.size() << " accepted\n";
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        if (ingest.isRejected(i)) std::cout << "Batch target " << batch[i].id << " rejected\n";
+    }
+
     // Large warhead count to trigger overflow in memory allocation
     unsigned int largeCount = UINT_MAX / 2;
     controller.allocateWarheadBuffer(largeCount);
 
-    controller.engageTargets();
+    if (checked) {
+        controller.engageTargetsChecked();
+    } else {
+        controller.engageTargets();
+    }
 
     return 0;
 }
@@ -0,0 +1,101 @@
+// Filling a header map from a parsed request and doing the lookups the
+// server makes while routing it: the flat Headers against the
+// std::unordered_multimap it replaced. The last case is a request at the
+// CPPHTTPLIB_HEADER_MAX_COUNT limit, the worst case for the linear scan on
+// insertion.
+//
+//   cd XSS/bench && g++ -std=c++11 -O2 -I.. headers_benchmark.cpp -o headers_benchmark -pthread
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "httplib.h"
+
+namespace baseline {
+
+// Headers as they were before the flat container
+using Headers = std::unordered_multimap<std::string, std::string, httplib::detail::case_ignore::hash,
+                                        httplib::detail::case_ignore::equal_to>;
+
+const char* get_header_value(const Headers& headers, const std::string& key) {
+    auto it = headers.find(key);
+    return it != headers.end() ? it->second.c_str() : "";
+}
+
+} // namespace baseline
+
+struct Case {
+    const char* label;
+    std::vector<std::string> lines;  // raw "Name: value" lines
+};
+
+// Names the server looks up for every request, whether present or not
+static const char* const kLookups[] = {
+    "Host",   "Content-Length", "Transfer-Encoding", "Connection",     "Expect",
+    "Cookie", "Range",          "Accept-Encoding",   "Content-Type",   "If-None-Match",
+};
+
+template <typename F>
+double ns_per_op(int iterations, F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) f();
+    auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    return ns.count() / iterations;
+}
+
+template <typename H>
+void parse_lines(const std::vector<std::string>& lines, H& headers) {
+    for (const std::string& line : lines) {
+        httplib::detail::parse_header(line.data(), line.data() + line.size(),
+                                      [&](const std::string& key, const std::string& val) {
+                                          headers.emplace(key, val);
+                                      });
+    }
+}
+
+int main() {
+    std::vector<Case> cases = {
+        {"curl GET",
+         {"Host: localhost:8080", "User-Agent: curl/8.5.0", "Accept: */*"}},
+        {"browser GET",
+         {"Host: localhost:8080", "Connection: keep-alive", "Upgrade-Insecure-Requests: 1",
+          "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 Chrome/126.0",
+          "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8",
+          "Sec-Fetch-Site: same-origin", "Sec-Fetch-Mode: navigate", "Sec-Fetch-Dest: document",
+          "Referer: http://localhost:8080/", "Accept-Encoding: gzip, deflate, br",
+          "Accept-Language: en-US,en;q=0.9", "Cookie: sessionid=abc123"}},
+        {"form POST",
+         {"Host: localhost:8080", "Connection: keep-alive", "Content-Length: 52",
+          "Content-Type: application/x-www-form-urlencoded", "Origin: http://localhost:8080",
+          "User-Agent: Mozilla/5.0", "Accept: text/html", "Referer: http://localhost:8080/",
+          "Accept-Encoding: gzip, deflate", "Cookie: SESSION_ID=0f3c9a1be27d44a1"}},
+    };
+    Case limit{"100 distinct fields", {}};
+    for (int i = 0; i < CPPHTTPLIB_HEADER_MAX_COUNT; ++i) {
+        limit.lines.push_back("X-Field-" + std::to_string(i) + ": value");
+    }
+    cases.push_back(limit);
+
+    const int iterations = 100000;
+    std::size_t sink = 0;
+    std::printf("%-20s %14s %12s %9s\n", "request", "multimap ns", "Headers ns", "speedup");
+    for (const Case& c : cases) {
+        double before = ns_per_op(iterations, [&] {
+            baseline::Headers headers;
+            parse_lines(c.lines, headers);
+            for (const char* k : kLookups) sink += *baseline::get_header_value(headers, k);
+        });
+        double after = ns_per_op(iterations, [&] {
+            httplib::Headers headers;
+            parse_lines(c.lines, headers);
+            for (const char* k : kLookups) {
+                sink += *httplib::detail::get_header_value(headers, k, "", 0);
+            }
+        });
+        std::printf("%-20s %14.1f %12.1f %8.2fx\n", c.label, before, after, before / after);
+    }
+    return sink == 0;  // keeps the work from being optimized away
+}
@@ -0,0 +1,127 @@
+// Query-string parsing followed by the get_param_value() calls the demo
+// handlers make: the flat Params with the in-place decoder against the
+// previous std::multimap path that built each key and value with
+// decode_url().
+//
+//   cd XSS/bench && g++ -std=c++11 -O2 -I.. params_benchmark.cpp -o params_benchmark -pthread
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "httplib.h"
+
+namespace baseline {
+
+// decode_url and parse_query_text as they were before Params was flattened
+std::string decode_url(const std::string& s, bool convert_plus_to_space) {
+    std::string result;
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '%' && i + 1 < s.size()) {
+            if (s[i + 1] == 'u') {
+                auto val = 0;
+                if (httplib::detail::from_hex_to_i(s, i + 2, 4, val)) {
+                    char buff[4];
+                    size_t len = httplib::detail::to_utf8(val, buff);
+                    if (len > 0) result.append(buff, len);
+                    i += 5;
+                } else {
+                    result += s[i];
+                }
+            } else {
+                auto val = 0;
+                if (httplib::detail::from_hex_to_i(s, i + 1, 2, val)) {
+                    result += static_cast<char>(val);
+                    i += 2;
+                } else {
+                    result += s[i];
+                }
+            }
+        } else if (convert_plus_to_space && s[i] == '+') {
+            result += ' ';
+        } else {
+            result += s[i];
+        }
+    }
+    return result;
+}
+
+using Params = std::multimap<std::string, std::string>;
+
+void parse_query_text(const std::string& s, Params& params) {
+    std::set<std::string> cache;
+    httplib::detail::split(s.data(), s.data() + s.size(), '&', [&](const char* b, const char* e) {
+        std::string kv(b, e);
+        if (cache.find(kv) != cache.end()) return;
+        cache.insert(std::move(kv));
+
+        std::string key;
+        std::string val;
+        httplib::detail::divide(b, static_cast<std::size_t>(e - b), '=',
+                                [&](const char* lhs, std::size_t lhs_size, const char* rhs,
+                                    std::size_t rhs_size) {
+                                    key.assign(lhs, lhs_size);
+                                    val.assign(rhs, rhs_size);
+                                });
+        if (!key.empty()) params.emplace(decode_url(key, true), decode_url(val, true));
+    });
+}
+
+std::string get_param_value(const Params& params, const std::string& key) {
+    auto it = params.find(key);
+    return it != params.end() ? it->second : std::string();
+}
+
+} // namespace baseline
+
+struct Case {
+    const char* label;
+    std::string query;
+    std::vector<std::string> keys;  // looked up after parsing, as a handler would
+};
+
+template <typename F>
+double ns_per_op(int iterations, F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) f();
+    auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    return ns.count() / iterations;
+}
+
+int main() {
+    std::vector<Case> cases = {
+        {"XSS /?name=", "name=John%20Doe", {"name"}},
+        {"SQL /login", "username=alice&password=alicepass", {"username", "password"}},
+        {"CSRF /change_email",
+         "email=new%40example.com&csrf_token=EBAFQsf6oYx8Et6l",
+         {"email", "csrf_token"}},
+        {"12 params, encoded",
+         "q=secure+coding+in+c%2B%2B&page=2&sort=date&order=desc&lang=en&tz=UTC%2B1&"
+         "ref=%2Fhome%3Fa%3D1&utm_source=news&utm_medium=email&utm_campaign=fall&"
+         "session=abc123&debug=0",
+         {"q", "page", "ref", "session"}},
+    };
+
+    const int iterations = 200000;
+    std::size_t sink = 0;
+    std::printf("%-22s %12s %12s %9s\n", "query", "multimap ns", "Params ns", "speedup");
+    for (const Case& c : cases) {
+        double before = ns_per_op(iterations, [&] {
+            baseline::Params params;
+            baseline::parse_query_text(c.query, params);
+            for (const std::string& k : c.keys) sink += baseline::get_param_value(params, k).size();
+        });
+        double after = ns_per_op(iterations, [&] {
+            httplib::Params params;
+            httplib::detail::parse_query_text(c.query, params);
+            for (const std::string& k : c.keys) {
+                auto it = params.find(k);
+                sink += it != params.end() ? it->second.size() : 0;
+            }
+        });
+        std::printf("%-22s %12.1f %12.1f %8.2fx\n", c.label, before, after, before / after);
+    }
+    return sink == 0;  // keeps the work from being optimized away
+}
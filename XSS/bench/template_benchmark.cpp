@@ -0,0 +1,240 @@
+// Rendering the demo pages with httplib::Template against the code it
+// replaced: string concatenation around the value (XSS offer page, CSRF
+// profile page) and find() + replace() on a copy of the page (SQL login
+// page). The CSRF profile template also escapes its three values, which the
+// old concatenation did not.
+//
+//   cd XSS/bench && g++ -std=c++11 -O2 -I.. template_benchmark.cpp -o template_benchmark -pthread
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include "httplib.h"
+
+// Page text as it was in the demos before templates
+const char* const offer_head = R"(<!DOCTYPE html>
+<html lang="en">
+<head>
+    <meta charset="UTF-8">
+    <meta name="viewport" content="width=device-width, initial-scale=1.0">
+    <title>Offer Letter</title>
+    <style>
+        body {
+            font-family: Arial, sans-serif;
+            background-color: #f4f4f4;
+            margin: 0;
+            padding: 20px;
+        }
+        .email-container {
+            max-width: 600px;
+            margin: 0 auto;
+            background: #ffffff;
+            padding: 20px;
+            border-radius: 8px;
+            box-shadow: 0 0 10px rgba(0, 0, 0, 0.1);
+        }
+        h1 {
+            color: #333;
+            text-align: center;
+        }
+        p {
+            color: #555;
+            line-height: 1.6;
+        }
+        .offer-details {
+            background: #f9f9f9;
+            padding: 15px;
+            border-radius: 8px;
+            margin-top: 20px;
+        }
+        .footer {
+            text-align: center;
+            margin-top: 20px;
+            color: #888;
+        }
+    </style>
+</head>
+<body>
+    <div class="email-container">
+        <h1>🎉 Congratulations, )";
+const char* const offer_tail = R"( ! 🎉</h1>
+        <p>We are thrilled to extend an offer for you to join our team at <strong>Awesome Company</strong>!</p>
+        <div class="offer-details">
+            <h2>Offer Details</h2>
+            <p><strong>Position:</strong> Software Engineer</p>
+            <p><strong>Start Date:</strong> January 1, 2024</p>
+            <p><strong>Salary:</strong> $100,000 per year</p>
+            <p><strong>Benefits:</strong> Health insurance, 401(k), and more!</p>
+        </div>
+        <p>Please review the details and let us know if you have any questions. We look forward to having you on board!</p>
+        <div class="footer">
+            <p>Best regards,</p>
+            <p><strong>The Awesome Company Team</strong></p>
+        </div>
+    </div>
+</body>
+</html>
+)";
+
+const char* const login_page_html = R"(
+<!DOCTYPE html>
+<html>
+<head>
+  <title>Login</title>
+  <style>
+    body {
+      font-family: 'Segoe UI', Tahoma, Geneva, Verdana, sans-serif;
+      background: #f0f2f5;
+      display: flex;
+      justify-content: center;
+      align-items: center;
+      height: 100vh;
+    }
+
+    .container {
+      background: white;
+      padding: 40px;
+      border-radius: 10px;
+      box-shadow: 0 8px 16px rgba(0, 0, 0, 0.2);
+      text-align: center;
+      width: 300px;
+    }
+
+    h2 {
+      margin-bottom: 20px;
+      color: #333;
+    }
+
+    input[type="text"], input[type="password"] {
+      width: 90%;
+      padding: 10px;
+      margin: 8px 0;
+      border: 1px solid #ccc;
+      border-radius: 5px;
+    }
+
+    input[type="submit"] {
+      width: 100%;
+      padding: 10px;
+      background-color: #4CAF50;
+      border: none;
+      color: white;
+      font-weight: bold;
+      border-radius: 5px;
+      cursor: pointer;
+    }
+
+    input[type="submit"]:hover {
+      background-color: #45a049;
+    }
+
+    .error {
+      color: red;
+      margin-top: 10px;
+    }
+  </style>
+</head>
+<body>
+  <div class="container">
+    <h2>Login</h2>
+    <form action="/login" method="post">
+      <input name="username" type="text" placeholder="Username" required /><br/>
+      <input name="password" type="password" placeholder="Password" required /><br/>
+      <input type="submit" value="Login" />
+    </form>
+    %ERROR_MSG%
+  </div>
+</body>
+</html>
+)";
+
+namespace baseline {
+
+std::string render_offer_html(const std::string& name) {
+    return offer_head + name + offer_tail;
+}
+
+std::string render_login_page(const char* error) {
+    std::string page(login_page_html);
+    size_t pos = page.find("%ERROR_MSG%");
+    if (pos != std::string::npos) {
+        page.replace(pos, 11, error);
+    }
+    return page;
+}
+
+std::string render_profile(const std::string& username, const std::string& email,
+                           const std::string& csrf_token) {
+    return R"(
+            <h2>Welcome, )" + username + R"(</h2>
+            <p>Current email: )" + email + R"(</p>
+            <form method="POST" action="/change_email">
+                New Email: <input name="email" type="text">
+                <input type="hidden" name="csrf_token" value=")" + csrf_token + R"(">
+                <input type="submit" value="Update Email">
+            </form>
+            <br><a href="/logout">Logout</a>
+        )";
+}
+
+} // namespace baseline
+
+template <typename F>
+double ns_per_op(int iterations, F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) f();
+    auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    return ns.count() / iterations;
+}
+
+int main() {
+    const httplib::Template offer_page(std::string(offer_head) + "{{{name}}}" + offer_tail,
+                                       {"name"});
+    std::string login_source(login_page_html);
+    login_source.replace(login_source.find("%ERROR_MSG%"), 11, "{{{error}}}");
+    const httplib::Template login_page(login_source, {"error"});
+    const httplib::Template profile_page(R"(
+            <h2>Welcome, {{username}}</h2>
+            <p>Current email: {{email}}</p>
+            <form method="POST" action="/change_email">
+                New Email: <input name="email" type="text">
+                <input type="hidden" name="csrf_token" value="{{csrf_token}}">
+                <input type="submit" value="Update Email">
+            </form>
+            <br><a href="/logout">Logout</a>
+        )", {"username", "email", "csrf_token"});
+
+    const std::string name = "New Hire";
+    const char* error = "<div class='error'>Invalid username or password</div>";
+    const std::string username = "admin", email = "admin@example.com",
+                      token = "EBAFQsf6oYx8Et6l";
+
+    const int iterations = 200000;
+    std::size_t sink = 0;
+    std::string buffer;
+    std::printf("%-26s %12s %12s %9s\n", "page", "before ns", "Template ns", "speedup");
+
+    auto report = [](const char* label, double before, double after) {
+        std::printf("%-26s %12.1f %12.1f %8.2fx\n", label, before, after, before / after);
+    };
+
+    report("XSS offer page",
+           ns_per_op(iterations, [&] { sink += baseline::render_offer_html(name).size(); }),
+           ns_per_op(iterations, [&] { sink += offer_page.render({name}).size(); }));
+    report("XSS offer page, reused",
+           ns_per_op(iterations, [&] { sink += baseline::render_offer_html(name).size(); }),
+           ns_per_op(iterations, [&] {
+               buffer.clear();
+               offer_page.render(buffer, {name});
+               sink += buffer.size();
+           }));
+    report("SQL login page, error",
+           ns_per_op(iterations, [&] { sink += baseline::render_login_page(error).size(); }),
+           ns_per_op(iterations, [&] { sink += login_page.render({error}).size(); }));
+    report("CSRF profile (escaped)",
+           ns_per_op(iterations,
+                     [&] { sink += baseline::render_profile(username, email, token).size(); }),
+           ns_per_op(iterations,
+                     [&] { sink += profile_page.render({username, email, token}).size(); }));
+    return sink == 0;  // keeps the work from being optimized away
+}
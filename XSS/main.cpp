@@ -2,8 +2,9 @@
 #include <string>
 #include "httplib.h"
 
-std::string render_offer_html(const std::string& name) {
-    return R"(<!DOCTYPE html>
+// Offer page, parsed once at startup. {{{name}}} is inserted without escaping:
+// this page is the reflected XSS example.
+const httplib::Template offer_page(R"(<!DOCTYPE html>
 <html lang="en">
 <head>
     <meta charset="UTF-8">
@@ -47,7 +48,7 @@ std::string render_offer_html(const std::string& name) {
 </head>
 <body>
     <div class="email-container">
-        <h1>🎉 Congratulations, )" + name + R"( ! 🎉</h1>
+        <h1>🎉 Congratulations, {{{name}}} ! 🎉</h1>
         <p>We are thrilled to extend an offer for you to join our team at <strong>Awesome Company</strong>!</p>
         <div class="offer-details">
             <h2>Offer Details</h2>
@@ -64,13 +65,22 @@ std::string render_offer_html(const std::string& name) {
     </div>
 </body>
 </html>
-)";
+)", {"name"});
+
+std::string render_offer_html(const std::string& name) {
+    return offer_page.render({name});
 }
 
 int main() {
     httplib::Server svr;
 
-    svr.Get("/", [](const httplib::Request& req, httplib::Response& res) {
+    // Rendered pages are kept per ?name= value (16 MB, one minute), so
+    // repeated requests skip rendering. The cached page still reflects the
+    // payload that was in the URL. Cookies are added outside the cache:
+    // responses that set them are never cached.
+    httplib::ResponseCache page_cache(16 * 1024 * 1024, std::chrono::minutes(1));
+
+    auto render_page = page_cache.wrap([](const httplib::Request& req, httplib::Response& res) {
         std::string name = "New Hire";
         if (req.has_param("name")) {
             name = req.get_param_value("name");
@@ -78,11 +88,15 @@ int main() {
 
         std::string html = render_offer_html(name);
         res.set_content(html, "text/html");
+    });
+
+    svr.Get("/", [render_page](const httplib::Request& req, httplib::Response& res) {
+        render_page(req, res);
 
-        res.set_header("Set-Cookie", "sessionid=abc123; Path=/");
-        res.set_header("Set-Cookie", "userid=42; Path=/");
-        res.set_header("Set-Cookie", "role=admin; Path=/");
-        res.set_header("Set-Cookie", "skey=156e4c789ik; Path=/");
+        res.add_cookie("sessionid", "abc123").path = "/";
+        res.add_cookie("userid", "42").path = "/";
+        res.add_cookie("role", "admin").path = "/";
+        res.add_cookie("skey", "156e4c789ik").path = "/";
     });
 
     std::cout << "Server running at http://localhost:8080\n";
@@ -0,0 +1,56 @@
+// Checks parsing of the request Cookie header: exact name matching,
+// whitespace and quotes around values, empty and malformed pairs, and the
+// first of repeated names winning. Exits non-zero on failure.
+//
+//   cd XSS/tests && g++ -std=c++11 -O2 -I.. cookie_header_test.cpp -o cookie_header_test -pthread
+
+#include <string>
+#include "check.h"
+#include "httplib.h"
+
+// A request carrying `cookie_header`, parsed as the server does
+static httplib::Request request_with(const std::string& cookie_header) {
+    httplib::Request req;
+    req.headers.emplace("Cookie", cookie_header);
+    auto it = req.headers.find(httplib::HeaderId::Cookie);
+    httplib::detail::parse_cookie_header(it->second, req.cookies);
+    return req;
+}
+
+int main() {
+    auto req = request_with("SESSION_ID=abc; theme=dark");
+    expect("values by name", req.get_cookie_value("SESSION_ID") == "abc" &&
+                                 req.get_cookie_value("theme") == "dark");
+
+    req = request_with("XSESSION_ID=evil; SESSION_ID_OLD=x");
+    expect("names match exactly, not as substrings", !req.has_cookie("SESSION_ID"));
+
+    req = request_with("a = 1 ;b=\"quoted value\";  c= ;d");
+    expect("whitespace around names and values is trimmed",
+           req.get_cookie_value("a") == "1" && req.has_cookie("c") &&
+               req.get_cookie_value("c").empty());
+    expect("surrounding quotes are removed", req.get_cookie_value("b") == "quoted value");
+
+    req = request_with("novalue; =orphan; ;; d=4");
+    expect("pairs without '=' or a name are skipped",
+           req.cookies.size() == 1 && req.get_cookie_value("d") == "4");
+
+    req = request_with("id=first; id=second");
+    expect("the first of repeated names wins", req.get_cookie_value("id") == "first");
+
+    req = request_with("k=v=w");
+    expect("'=' inside a value is kept", req.get_cookie_value("k") == "v=w");
+
+    size_t len = 0;
+    req = request_with("token=xyz123");
+    const char* p = req.get_cookie_value("token", len);
+    const std::string& header = req.headers.find(httplib::HeaderId::Cookie)->second;
+    expect("pointer overload points into the header without copying",
+           p == header.data() + 6 && len == 6 && std::string(p, len) == "xyz123");
+
+    httplib::Request none;
+    expect("no Cookie header", !none.has_cookie("SESSION_ID") &&
+                                   none.get_cookie_value("SESSION_ID").empty());
+
+    return check_result();
+}
@@ -0,0 +1,81 @@
+// Checks Headers: case-insensitive lookups by name and HeaderId, grouping of
+// repeated fields, erase/clear, many distinct names, and read_headers()
+// stopping at CPPHTTPLIB_HEADER_MAX_COUNT fields. Exits non-zero on failure.
+//
+//   cd XSS/tests && g++ -std=c++11 -O2 -I.. headers_test.cpp -o headers_test -pthread
+
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "check.h"
+#include "httplib.h"
+
+using httplib::HeaderId;
+using httplib::Headers;
+
+// Rewriting a name in place would leave its cached hash and id stale
+using HeadersItem = std::remove_reference<decltype(*std::declval<Headers&>().begin())>::type;
+static_assert(std::is_const<HeadersItem>::value, "Headers iterators must be read-only");
+
+static std::vector<std::string> values(const Headers& headers, const std::string& key) {
+    std::vector<std::string> out;
+    auto r = headers.equal_range(key);
+    for (auto it = r.first; it != r.second; ++it) out.push_back(it->second);
+    return out;
+}
+
+// Feeds `text` through read_headers()
+static bool read(const std::string& text, Headers& headers) {
+    httplib::detail::BufferStream strm;
+    strm.write(text.data(), text.size());
+    return httplib::detail::read_headers(strm, headers);
+}
+
+int main() {
+    Headers h;
+    h.emplace("Content-Type", "text/html");
+    h.emplace("X-Trace", "1");
+    h.emplace("Accept", "*/*");
+    h.emplace("x-trace", "2");
+
+    expect("lookup ignores case", h.find("content-TYPE") != h.end() &&
+                                      h.find("content-TYPE")->second == "text/html");
+    expect("lookup by HeaderId", h.find(HeaderId::ContentType) != h.end() &&
+                                     h.find(HeaderId::Accept)->second == "*/*" &&
+                                     h.find(HeaderId::Host) == h.end());
+    expect("repeated names stay adjacent, in order",
+           values(h, "X-TRACE") == std::vector<std::string>{"1", "2"} && h.count("x-trace") == 2);
+    expect("get_header_value by index",
+           std::string(httplib::detail::get_header_value(h, "X-Trace", "", 1)) == "2" &&
+               std::string(httplib::detail::get_header_value(h, "X-Trace", "none", 2)) == "none");
+    expect("missing name", h.find("Cookie") == h.end() && h.count("Cookie") == 0);
+
+    expect("erase by name", h.erase("X-Trace") == 2 && h.find("x-trace") == h.end() &&
+                                h.size() == 2 && h.find(HeaderId::Accept) != h.end());
+    h.clear();
+    expect("clear forgets every name", h.empty() && h.find("Content-Type") == h.end() &&
+                                           h.find(HeaderId::ContentType) == h.end());
+
+    // Far more names than the 256-bit name filter can tell apart
+    for (int i = 0; i < 500; ++i) h.emplace("X-Field-" + std::to_string(i), std::to_string(i));
+    bool all_found = true;
+    for (int i = 0; i < 500; ++i) {
+        auto it = h.find("x-field-" + std::to_string(i));
+        all_found = all_found && it != h.end() && it->second == std::to_string(i);
+    }
+    expect("500 distinct names are all found", all_found && h.size() == 500);
+
+    Headers parsed;
+    expect("read_headers parses fields",
+           read("Host: example.com\r\nCookie: a=1\r\nCookie: b=2\r\n\r\n", parsed) &&
+               parsed.find(HeaderId::Host)->second == "example.com" &&
+               values(parsed, "cookie") == std::vector<std::string>{"a=1", "b=2"});
+
+    std::string many;
+    for (int i = 0; i <= CPPHTTPLIB_HEADER_MAX_COUNT; ++i) many += "X-" + std::to_string(i) + ": v\r\n";
+    Headers too_many;
+    expect("read_headers rejects more than CPPHTTPLIB_HEADER_MAX_COUNT fields",
+           !read(many + "\r\n", too_many) && too_many.size() == CPPHTTPLIB_HEADER_MAX_COUNT);
+
+    return check_result();
+}
@@ -0,0 +1,76 @@
+// Checks query parsing into Params: decoding, ordering, repeated keys and
+// duplicate pairs, and lookups after bulk and single inserts. Exits non-zero
+// on failure.
+//
+//   cd XSS/tests && g++ -std=c++11 -O2 -I.. params_test.cpp -o params_test -pthread
+
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "check.h"
+#include "httplib.h"
+
+using httplib::Params;
+
+// Rewriting a key in place would break the sorted order lookups rely on
+using ParamsItem = std::remove_reference<decltype(*std::declval<Params&>().begin())>::type;
+static_assert(std::is_const<ParamsItem>::value, "Params iterators must be read-only");
+
+static Params parse(const std::string& query) {
+    Params params;
+    httplib::detail::parse_query_text(query, params);
+    return params;
+}
+
+static std::vector<std::string> values(const Params& params, const std::string& key) {
+    std::vector<std::string> out;
+    auto r = params.equal_range(key);
+    for (auto it = r.first; it != r.second; ++it) out.push_back(it->second);
+    return out;
+}
+
+static bool sorted(const Params& params) {
+    for (auto it = params.begin(); it != params.end() && std::next(it) != params.end(); ++it) {
+        if (std::next(it)->first < it->first) return false;
+    }
+    return true;
+}
+
+int main() {
+    Params p = parse("name=J%C3%B6rg+Doe&city=K%C3%B6ln");
+    expect("values are percent- and plus-decoded",
+           p.find("name") != p.end() && p.find("name")->second == "J\xc3\xb6rg Doe" &&
+               p.find("city")->second == "K\xc3\xb6ln");
+
+    p = parse("b=2&a=1&c=3&a=0");
+    expect("keys are sorted", sorted(p) && p.begin()->first == "a");
+    expect("repeated keys keep their order", values(p, "a") == std::vector<std::string>{"1", "0"});
+    expect("count", p.count("a") == 2 && p.count("b") == 1 && p.count("z") == 0);
+
+    p = parse("a=1&b=2&a=1&a=2");
+    expect("identical pairs are kept once", values(p, "a") == std::vector<std::string>{"1", "2"});
+
+    p = parse("=x&b&&c=");
+    expect("empty keys are skipped, missing values are empty",
+           p.size() == 2 && p.find("b")->second.empty() && p.find("c")->second.empty());
+
+    p = parse("k%3Db=v%26w");
+    expect("encoded separators stay inside the key and value",
+           p.size() == 1 && p.begin()->first == "k=b" && p.begin()->second == "v&w");
+
+    // More than eight items take the sort-and-merge path
+    std::string query;
+    for (int i = 20; i > 0; --i) query += "k" + std::to_string(i % 7) + "=" + std::to_string(i) + "&";
+    p = parse(query);
+    expect("bulk insert keeps keys sorted", p.size() == 20 && sorted(p));
+    expect("bulk insert keeps repeated keys in order",
+           values(p, "k3") == std::vector<std::string>{"17", "10", "3"});
+
+    p.emplace("k3", "x");
+    p.emplace("a", "first");
+    expect("emplace keeps the order", sorted(p) && p.begin()->second == "first" &&
+                                          values(p, "k3").back() == "x");
+    expect("erase by key", p.erase("k3") == 4 && p.find("k3") == p.end() && sorted(p));
+
+    return check_result();
+}
@@ -0,0 +1,87 @@
+// Checks that ResponseCache::default_key gives distinct keys to requests
+// whose decoded parameters differ, even when one value spells out another
+// parameter list, and the same key to reordered query strings; and that
+// responses setting cookies or marked private are never replayed to another
+// request. Exits non-zero on failure.
+//
+//   cd XSS/tests && g++ -std=c++11 -O2 -I.. response_cache_test.cpp -o response_cache_test -pthread
+
+#include <chrono>
+#include <string>
+#include "check.h"
+#include "httplib.h"
+
+static std::string key_for(const std::string& path, const std::string& query) {
+    httplib::Request req;
+    req.path = path;
+    httplib::detail::parse_query_text(query, req.params);
+    return httplib::ResponseCache::default_key(req);
+}
+
+// Runs a GET for "/" through `handler`
+static httplib::Response get(const httplib::Server::Handler& handler) {
+    httplib::Request req;
+    req.method = "GET";
+    req.method_id_ = httplib::Method::Get;
+    req.path = "/";
+    httplib::Response res;
+    handler(req, res);
+    return res;
+}
+
+// How many of two identical GETs reach a handler that marks its response
+// with `mark`; 1 means the second was answered from the cache
+static int handler_calls(void (*mark)(httplib::Response&, int)) {
+    httplib::ResponseCache cache(1 << 20, std::chrono::seconds(60));
+    int calls = 0;
+    auto handler = cache.wrap([&](const httplib::Request&, httplib::Response& res) {
+        mark(res, ++calls);
+        res.set_content("hello", "text/plain");
+    });
+    get(handler);
+    get(handler);
+    return calls;
+}
+
+int main() {
+    expect("encoded separators do not forge a second parameter",
+           key_for("/", "a=x%00name%3Devil") != key_for("/", "a=x&name=evil"));
+    expect("encoded '=' does not move the name/value split",
+           key_for("/", "a%3Db=c") != key_for("/", "a=b%3Dc"));
+    expect("path and parameters stay apart",
+           key_for("/a", "") != key_for("/", "a="));
+    expect("values differ", key_for("/", "name=alice") != key_for("/", "name=bob"));
+    expect("reordered query strings share a key",
+           key_for("/", "a=1&b=2") == key_for("/", "b=2&a=1"));
+
+    expect("plain responses are cached",
+           handler_calls([](httplib::Response&, int) {}) == 1);
+    expect("responses with cookies are not cached",
+           handler_calls([](httplib::Response& res, int n) {
+               res.add_cookie("SESSION_ID", "user" + std::to_string(n));
+           }) == 2);
+    expect("responses with a Set-Cookie header are not cached",
+           handler_calls([](httplib::Response& res, int n) {
+               res.set_header("Set-Cookie", "SESSION_ID=user" + std::to_string(n));
+           }) == 2);
+    expect("private and no-store responses are not cached",
+           handler_calls([](httplib::Response& res, int) {
+               res.set_header("Cache-Control", "private, max-age=60");
+           }) == 2 &&
+               handler_calls([](httplib::Response& res, int) {
+                   res.set_header("Cache-Control", "no-store");
+               }) == 2);
+
+    httplib::ResponseCache cache(1 << 20, std::chrono::seconds(60));
+    int calls = 0;
+    auto handler = cache.wrap([&](const httplib::Request&, httplib::Response& res) {
+        if (++calls == 1) res.add_cookie("SESSION_ID", "first-user");
+        res.set_content("hello", "text/plain");
+    });
+    get(handler);
+    auto second = get(handler);
+    expect("a later request never receives an earlier user's cookie",
+           calls == 2 && second.cookies.empty() && !second.has_header("Set-Cookie"));
+
+    return check_result();
+}
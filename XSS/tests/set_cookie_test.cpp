@@ -0,0 +1,141 @@
+// Checks that Response cookies with an invalid value, Path, Domain or
+// SameSite are dropped, that the ones written are visible through
+// has_header / get_header_value as Set-Cookie fields, and that a served
+// response carries them after its other headers, through a custom header
+// writer. Exits non-zero on failure.
+//
+//   cd XSS/tests && g++ -std=c++11 -O2 -I.. set_cookie_test.cpp -o set_cookie_test -pthread
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "check.h"
+#include "httplib.h"
+
+// The Set-Cookie line written for a single cookie, or "" if it is dropped
+template <typename Fn>
+static std::string line_for(const std::string& name, const std::string& value, Fn set) {
+    httplib::Response res;
+    set(res.add_cookie(name, value));
+    return res.get_header_value("Set-Cookie");
+}
+
+static std::string line_for(const std::string& name, const std::string& value) {
+    return line_for(name, value, [](httplib::SetCookie&) {});
+}
+
+// The raw bytes a server on 127.0.0.1:`port` sends back for GET `path`
+static std::string fetch(int port, const std::string& path) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    std::string out;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+        std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+        if (send(fd, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size())) {
+            char buf[4096];
+            ssize_t n;
+            while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) out.append(buf, static_cast<size_t>(n));
+        }
+    }
+    close(fd);
+    return out;
+}
+
+int main() {
+    expect("plain value", line_for("id", "abc123") == "id=abc123");
+    expect("quoted value", line_for("id", "\"abc\"") == "id=\"abc\"");
+    expect("all attributes", line_for("id", "x", [](httplib::SetCookie& c) {
+                                 c.path = "/";
+                                 c.domain = "example.com";
+                                 c.max_age = 60;
+                                 c.secure = true;
+                                 c.http_only = true;
+                                 c.same_site = "Lax";
+                             }) == "id=x; Path=/; Domain=example.com; Max-Age=60; Secure; "
+                                   "HttpOnly; SameSite=Lax");
+
+    expect("value with ';' is dropped", line_for("id", "x; Domain=evil.com").empty());
+    expect("value with ',' is dropped", line_for("id", "a,b").empty());
+    expect("value with a space is dropped", line_for("id", "a b").empty());
+    expect("value with '\\' is dropped", line_for("id", "a\\b").empty());
+    expect("value with CRLF is dropped", line_for("id", "x\r\nLocation: /").empty());
+    expect("unbalanced quote is dropped", line_for("id", "\"abc").empty());
+    expect("bad name is dropped", line_for("a b", "x").empty());
+
+    expect("path with ';' is dropped", line_for("id", "x", [](httplib::SetCookie& c) {
+                                           c.path = "/; Secure";
+                                       }).empty());
+    expect("domain with ',' is dropped", line_for("id", "x", [](httplib::SetCookie& c) {
+                                             c.domain = "a.com,b.com";
+                                         }).empty());
+    expect("path with a control character is dropped",
+           line_for("id", "x", [](httplib::SetCookie& c) { c.path = "/\t"; }).empty());
+    expect("unknown SameSite is dropped", line_for("id", "x", [](httplib::SetCookie& c) {
+                                              c.same_site = "Lax; Domain=evil.com";
+                                          }).empty());
+
+    httplib::Response res;
+    expect("no cookies, no Set-Cookie", !res.has_header("Set-Cookie"));
+    res.set_header("Set-Cookie", "a=1");
+    res.add_cookie("b", "2");
+    res.add_cookie("c", "bad value");
+    res.add_cookie("d", "4");
+    expect("cookies count as Set-Cookie fields", res.get_header_value_count("Set-Cookie") == 3);
+    expect("header fields come first", res.get_header_value("set-cookie", "", 0) == "a=1");
+    expect("then the cookies, invalid ones skipped",
+           res.get_header_value("Set-Cookie", "", 1) == "b=2" &&
+               res.get_header_value(httplib::HeaderId::SetCookie, "", 2) == "d=4" &&
+               res.get_header_value("Set-Cookie", "none", 3) == "none");
+
+    httplib::Response only_cookies;
+    only_cookies.add_cookie("id", "x");
+    expect("has_header sees cookies", only_cookies.has_header("Set-Cookie") &&
+                                          only_cookies.has_header(httplib::HeaderId::SetCookie));
+
+    httplib::Server svr;
+    std::atomic<int> written(0);
+    svr.set_header_writer([&](httplib::Stream& strm, httplib::Headers& headers) {
+        written += static_cast<int>(headers.count("Set-Cookie"));
+        return httplib::detail::write_headers(strm, headers);
+    });
+    svr.Get("/cookies", [](const httplib::Request&, httplib::Response& res) {
+        res.set_content("hi", "text/plain");
+        res.add_cookie("b", "2").path = "/";
+        res.add_cookie("c", "bad value");
+        res.add_cookie("d", "4");
+    });
+    svr.Get("/mixed", [](const httplib::Request&, httplib::Response& res) {
+        res.set_header("Set-Cookie", "a=1");
+        res.set_content("hi", "text/plain");
+        res.add_cookie("b", "2");
+    });
+    int port = svr.bind_to_any_port("127.0.0.1");
+    std::thread server([&] { svr.listen_after_bind(); });
+    svr.wait_until_ready();
+
+    std::string bytes = fetch(port, "/cookies");
+    auto head_end = bytes.find("\r\n\r\n");
+    const std::string lines = "\r\nSet-Cookie: b=2; Path=/\r\nSet-Cookie: d=4";
+    auto cookies = bytes.find(lines);
+    expect("cookies are the last header lines",
+           head_end != std::string::npos && cookies != std::string::npos &&
+               cookies + lines.size() == head_end &&
+               bytes.find("\r\nContent-Type: text/plain\r\n") < cookies &&
+               bytes.find("\r\nContent-Length: 2\r\n") < cookies);
+    expect("invalid cookies are not written", bytes.find("c=bad") == std::string::npos);
+    expect("cookies go through the custom header writer", written == 2);
+
+    bytes = fetch(port, "/mixed");
+    expect("header Set-Cookie fields come before the cookies",
+           bytes.find("\r\nSet-Cookie: a=1\r\nSet-Cookie: b=2\r\n") != std::string::npos &&
+               written == 4);
+
+    svr.stop();
+    server.join();
+
+    return check_result();
+}
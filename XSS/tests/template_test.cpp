@@ -0,0 +1,72 @@
+// Checks Template: escaping by context (HTML text, tag attributes, raw),
+// repeated and padded placeholders, appending renders, and the errors for
+// unknown or unterminated placeholders and wrong value counts. Exits
+// non-zero on failure.
+//
+//   cd XSS/tests && g++ -std=c++11 -O2 -I.. template_test.cpp -o template_test -pthread
+
+#include <stdexcept>
+#include <string>
+#include "check.h"
+#include "httplib.h"
+
+using httplib::Template;
+
+// True if building a template from `source` with the one field "name" throws
+static bool rejects(const std::string& source) {
+    try {
+        Template t(source, {"name"});
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    const std::string attack = "<script>alert('x')</script>";
+
+    Template text("<p>Hello, {{name}}!</p>", {"name"});
+    expect("text placeholders escape the five special characters",
+           text.render({attack}) == "<p>Hello, &lt;script&gt;alert(&#39;x&#39;)&lt;/script&gt;!</p>");
+    expect("text placeholders keep plain values", text.render({"Bob"}) == "<p>Hello, Bob!</p>");
+
+    Template attr("<input value=\"{{name}}\"><a href={{name}}>{{name}}</a>", {"name"});
+    expect("attribute placeholders hex-escape punctuation, text ones use entities",
+           attr.render({"a\" onclick=x"}) ==
+               "<input value=\"a&#x22;&#x20;onclick&#x3D;x\">"
+               "<a href=a&#x22;&#x20;onclick&#x3D;x>a&quot; onclick=x</a>");
+
+    Template quoted("<a title=\"x > y\" href=\"{{name}}\">{{name}}</a>", {"name"});
+    expect("'>' inside a quoted attribute does not end the tag",
+           quoted.render({"<"}) == "<a title=\"x > y\" href=\"&#x3C;\">&lt;</a>");
+
+    Template raw("<div>{{{name}}}</div>", {"name"});
+    expect("raw placeholders insert the value verbatim",
+           raw.render({attack}) == "<div>" + attack + "</div>");
+
+    Template two("{{ first }} and {{second}}, {{first}}", {"first", "second"});
+    expect("padded and repeated placeholders", two.render({"A", "B"}) == "A and B, A");
+
+    std::string out = "prefix:";
+    text.render(out, {"x"});
+    expect("render(out, ...) appends", out == "prefix:<p>Hello, x!</p>");
+
+    Template utf8("<b>{{name}}</b><i title={{name}}>", {"name"});
+    expect("UTF-8 passes through both escapers",
+           utf8.render({"J\xc3\xb6rg"}) == "<b>J\xc3\xb6rg</b><i title=J\xc3\xb6rg>");
+
+    expect("unknown placeholder is rejected", rejects("Hi {{other}}"));
+    expect("unterminated placeholder is rejected", rejects("Hi {{name"));
+    expect("unterminated raw placeholder is rejected", rejects("Hi {{{name}}"));
+    expect("valid template is accepted", !rejects("Hi {{name}}") && text.is_valid());
+
+    bool threw = false;
+    try {
+        two.render({"only one"});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    expect("too few values are rejected", threw);
+
+    return check_result();
+}
@@ -0,0 +1,55 @@
+// Checks that detail::timer_wheel fires each deadline on its own tick,
+// including deadlines just past a 2^24-tick boundary and deadlines beyond
+// the range of the top level. Exits non-zero on failure.
+//
+//   cd XSS/tests && g++ -std=c++11 -O2 -I.. timer_wheel_test.cpp -o timer_wheel_test -pthread
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "check.h"
+#include "httplib.h"
+
+using httplib::detail::timer_wheel;
+using ticks = std::chrono::milliseconds;
+
+// Schedules a timer `delay` ticks after tick `start` and reports the tick it
+// actually fired on.
+static void expect_fires_on_time(const char* label, uint64_t start, uint64_t delay) {
+    auto origin = timer_wheel::clock::time_point();
+    timer_wheel wheel(ticks(1), origin);
+    wheel.advance(origin + ticks(start), [](socket_t) {});
+
+    auto due = start + delay;
+    wheel.schedule(origin + ticks(due), 1);
+
+    uint64_t fired = 0;
+    bool done = false;
+    // Step one tick at a time near the deadline, in large strides before it
+    for (uint64_t now = start; !done && now <= due + 1024;) {
+        now = now + 4096 < due ? now + 4096 : now + 1;
+        wheel.advance(origin + ticks(now), [&](socket_t) {
+            fired = now;
+            done = true;
+        });
+    }
+
+    if (!expect(label, fired == due && wheel.size() == 0)) {
+        std::printf("     due at tick %llu, fired at %llu\n", static_cast<unsigned long long>(due),
+                    static_cast<unsigned long long>(fired));
+    }
+}
+
+int main() {
+    const uint64_t span = uint64_t(1) << 24;  // range of the top level
+
+    expect_fires_on_time("short deadline", 0, 5);
+    expect_fires_on_time("crosses a level-1 boundary", 60, 10);
+    expect_fires_on_time("crosses the 2^24 boundary", span - 10, 15);
+    expect_fires_on_time("crosses 2^24 from mid-slot", span - 300000, 400000);
+    expect_fires_on_time("just under the top-level range", 12345, span - 1);
+    expect_fires_on_time("beyond the top-level range", 12345, span + 777);
+
+    return check_result();
+}